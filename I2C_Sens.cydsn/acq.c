@@ -0,0 +1,278 @@
+#include "acq.h"
+#include "bmp180.h"
+#include "out.h"
+#include "timebase.h"
+#include "rx.h"
+#include "baud.h"
+#include "clock.h"
+#include "hib.h"
+#include "sampleq.h"
+
+Acq_Stats Acq_stats;
+Acq_ConvStats Acq_tempConv;
+Acq_ConvStats Acq_presConv;
+
+static uint8 acqMode;
+static uint8 acqWait;
+static uint8 acqPending;        // Temperaturwandlung laeuft bereits
+static uint32 acqTrigger;       // Time_Us32() beim letzten Wandlungsstart
+static uint64 acqLast;          // Zeitpunkt der letzten fertigen Messung in us
+static uint32 acqSeq;
+static uint32 acqPeriod;        // us, 0 = freilaufend
+static uint64 acqDeadline;      // naechster geplanter Start
+static uint8 acqScheduled;
+static uint64 acqStart;         // Zeitstempel der laufenden Temperaturwandlung
+static uint8 acqErrors;         // Stand von BMP180_errors nach der letzten Messung
+static void (*acqConsume)(void);
+
+
+// Arbeit, die waehrend der Wartezeiten erledigt wird
+static void Acq_Idle(void)
+{
+    Out_Poll();
+    // ab 57600 Baud laeuft der 4 Byte FIFO zwischen zwei SysTicks ueber
+    Rx_Service();
+    Baud_Poll();
+    if (acqConsume != NULL)
+    {
+        acqConsume();
+    }
+    Clock_Idle();
+}
+
+static void Acq_RecordConv(Acq_ConvStats *conv, uint32 us)
+{
+    conv->count++;
+    conv->sumUs += us;
+    if (us < conv->minUs)
+    {
+        conv->minUs = us;
+    }
+    if (us > conv->maxUs)
+    {
+        conv->maxUs = us;
+    }
+}
+
+static void Acq_Wait(uint32 ms, Acq_ConvStats *conv)
+{
+    uint32 elapsed;
+
+    if (acqWait == ACQ_WAIT_FIXED)
+    {
+        uint32 us = ms * 1000u;
+        // mindestens einmal, damit der Consumer auch bei Verspaetung drankommt
+        do
+        {
+            Acq_Idle();
+        } while ((elapsed = Time_Us32() - acqTrigger) < us);
+        Acq_RecordConv(conv, elapsed);
+        return;
+    }
+
+    uint32 limit = (ms + ACQ_EOC_TIMEOUT_MS) * 1000u;
+    uint32 next = ACQ_EOC_FIRST_POLL_US;
+    uint32 step = ACQ_EOC_POLL_US;
+
+    for (;;)
+    {
+        elapsed = Time_Us32() - acqTrigger;
+        if (elapsed >= limit)
+        {
+            conv->timeouts++;
+            break;
+        }
+        if (elapsed >= next)
+        {
+            conv->polls++;
+            if (BMP180_ConversionDone())
+            {
+                break;
+            }
+            next = elapsed + step;
+            if (step < ACQ_EOC_POLL_MAX_US)
+            {
+                step *= 2;
+            }
+        }
+        Acq_Idle();
+    }
+    Acq_RecordConv(conv, Time_Us32() - acqTrigger);
+}
+
+static void Acq_ResetConv(Acq_ConvStats *conv)
+{
+    conv->count = 0;
+    conv->minUs = 0xFFFFFFFFu;
+    conv->maxUs = 0;
+    conv->sumUs = 0;
+    conv->polls = 0;
+    conv->timeouts = 0;
+}
+
+void Acq_Init(uint8 mode, uint8 wait, uint32 periodUs)
+{
+    acqMode = mode;
+    acqWait = wait;
+    acqPending = 0;
+    acqErrors = BMP180_errors;
+    Acq_SetPeriod(periodUs);
+    Acq_ResetStats();
+}
+
+void Acq_Prime(void)
+{
+    BMP180_StartTemperature();
+    acqStart = Time_Us();
+    acqTrigger = (uint32)acqStart;
+    acqPending = 1;
+}
+
+void Acq_SetPeriod(uint32 periodUs)
+{
+    acqPeriod = periodUs;
+    acqScheduled = 0;
+}
+
+// bis zum naechsten Termin warten, Verspaetung mitschreiben
+static void Acq_WaitDeadline(void)
+{
+    uint64 now = Time_Us();
+
+    if (!acqScheduled)
+    {
+        acqDeadline = now;
+        acqScheduled = 1;
+    }
+    while (now < acqDeadline)
+    {
+        Acq_Idle();
+#if HIB_ENABLE
+        if (acqPeriod >= HIB_MIN_PERIOD_US)
+        {
+            Hib_Idle(acqDeadline);
+        }
+#endif
+        now = Time_Us();
+    }
+
+    uint32 late = (uint32)(now - acqDeadline);
+    Acq_stats.jitterSum += late;
+    Acq_stats.jitterCount++;
+    if (late > Acq_stats.jitterMax)
+    {
+        Acq_stats.jitterMax = late;
+    }
+
+    acqDeadline += acqPeriod;
+    while (acqDeadline <= now)
+    {
+        acqDeadline += acqPeriod;
+        Acq_stats.missed++;
+    }
+}
+
+void Acq_SetMode(uint8 mode)
+{
+    acqMode = mode;
+}
+
+uint8 Acq_GetMode(void)
+{
+    return acqMode;
+}
+
+void Acq_Next(Acq_Sample *sample)
+{
+    // Time_Us(), nicht Perf_Cycles(): DWT steht im Schlaf (hib.c) und laeuft
+    // bei 24 MHz nach 179 s ueber
+    uint64 enter = Time_Us();
+
+    if (!acqPending)
+    {
+        if (acqPeriod > 0)
+        {
+            Acq_WaitDeadline();
+            enter = Time_Us();
+        }
+        BMP180_StartTemperature();
+        acqStart = Time_Us();
+        acqTrigger = (uint32)acqStart;
+    }
+    sample->tStart = acqStart;
+    Acq_Wait(BMP180_TEMP_CONV_MS, &Acq_tempConv);
+    sample->ut = (int16)BMP180_ReadResult();
+
+    BMP180_StartPressure();
+    acqTrigger = Time_Us32();
+    Acq_Wait(BMP180_PressureConvMs(), &Acq_presConv);
+    sample->up = BMP180_ReadPressureResult();
+    sample->tEnd = Time_Us();
+    sample->seq = acqSeq++;
+    sample->errors = (uint8)(BMP180_errors - acqErrors);
+    acqErrors = BMP180_errors;
+
+    acqPending = (acqMode == ACQ_MODE_PIPELINED) && (acqPeriod == 0);
+    if (acqPending)
+    {
+        BMP180_StartTemperature();
+        acqStart = Time_Us();
+        acqTrigger = (uint32)acqStart;
+    }
+
+    uint64 now = Time_Us();
+    Acq_stats.waitSum += now - enter;
+    if (Acq_stats.samples > 0)
+    {
+        uint32 period = (uint32)(now - acqLast);
+        Acq_stats.periodSum += period;
+        if (period < Acq_stats.periodMin)
+        {
+            Acq_stats.periodMin = period;
+        }
+        if (period > Acq_stats.periodMax)
+        {
+            Acq_stats.periodMax = period;
+        }
+    }
+    acqLast = now;
+    Acq_stats.samples++;
+}
+
+void Acq_Produce(struct SampleQ *queue)
+{
+    Acq_Sample sample;
+
+    Acq_Next(&sample);
+    // voll: zaehlt in queue->drops, die Sequenznummer zeigt die Luecke
+    (void)SampleQ_Push(queue, &sample);
+}
+
+void Acq_SetConsumer(void (*consume)(void))
+{
+    acqConsume = consume;
+}
+
+void Acq_ResetStats(void)
+{
+    Acq_stats.samples = 0;
+    Acq_stats.periodMin = 0xFFFFFFFFu;
+    Acq_stats.periodMax = 0;
+    Acq_stats.periodSum = 0;
+    Acq_stats.waitSum = 0;
+    Acq_stats.jitterMax = 0;
+    Acq_stats.jitterSum = 0;
+    Acq_stats.jitterCount = 0;
+    Acq_stats.missed = 0;
+    Acq_ResetConv(&Acq_tempConv);
+    Acq_ResetConv(&Acq_presConv);
+}
+
+uint32 Acq_SamplesPerSecondX100(void)
+{
+    if ((Acq_stats.samples < 2) || (Acq_stats.periodSum == 0))
+    {
+        return 0;
+    }
+    return (uint32)(((uint64)(Acq_stats.samples - 1) * 100000000u) / Acq_stats.periodSum);
+}
@@ -0,0 +1,89 @@
+#ifndef ACQ_H
+#define ACQ_H
+
+#include "project.h"
+
+#define ACQ_MODE_SEQUENTIAL 0u
+#define ACQ_MODE_PIPELINED  1u
+
+// Warten auf Wandlungsende: feste worst case Zeit oder Sco/EOC abfragen
+#define ACQ_WAIT_FIXED      0u
+#define ACQ_WAIT_EOC        1u
+
+#define ACQ_EOC_FIRST_POLL_US   3000u   // vorher ist keine Wandlung fertig
+#define ACQ_EOC_POLL_US         250u    // Abstand der Abfragen, verdoppelt sich bis ..
+#define ACQ_EOC_POLL_MAX_US     1000u
+#define ACQ_EOC_TIMEOUT_MS      4u      // .. Zuschlag auf die worst case Zeit
+
+// Durchsatz Zeilen alle ACQ_STATS_PERIOD_US und auf STATS. Nach Zeit, nicht
+// nach Messungen: rund 400 Byte Stats je 32 Messungen belegen bei 9600 Baud
+// allein ~40 % der UART, dann bremst die Ausgabe die Erfassung.
+#define ACQ_STATS_PERIOD_US 10000000u
+
+typedef struct
+{
+    uint32 seq;             // fortlaufende Nummer, Luecken zeigen verlorene Messungen
+    int16 ut;
+    int32 up;
+    uint64 tStart;          // us, Start der Temperaturwandlung
+    uint64 tEnd;            // us, Druckergebnis gelesen
+    uint8 errors;           // fehlgeschlagene Buszugriffe, Werte dann unbrauchbar
+} Acq_Sample;
+
+typedef struct
+{
+    uint32 samples;
+    uint32 periodMin;       // us zwischen zwei Messungen
+    uint32 periodMax;
+    uint64 periodSum;
+    uint64 waitSum;         // us in Acq_Next(), darin laufen auch Out_Poll() und der Consumer
+    uint32 jitterMax;       // us Verspaetung gegenueber dem geplanten Start
+    uint32 jitterSum;
+    uint32 jitterCount;
+    uint32 missed;          // ausgelassene Termine
+} Acq_Stats;
+
+// beobachtete Wandlungszeiten
+typedef struct
+{
+    uint32 count;
+    uint32 minUs;
+    uint32 maxUs;
+    uint32 sumUs;
+    uint32 polls;
+    uint32 timeouts;
+} Acq_ConvStats;
+
+extern Acq_Stats Acq_stats;
+extern Acq_ConvStats Acq_tempConv;
+extern Acq_ConvStats Acq_presConv;
+
+// periodUs > 0: Messungen starten zu festen Terminen (Start + n * Periode),
+// ohne dass sich Laufzeiten aufaddieren. Im Pipeline Modus wird dann nicht
+// vorab getriggert. periodUs == 0: so schnell wie moeglich.
+void Acq_Init(uint8 mode, uint8 wait, uint32 periodUs);
+void Acq_SetPeriod(uint32 periodUs);
+void Acq_SetMode(uint8 mode);
+
+// erste Temperaturwandlung sofort starten, Acq_Next() holt sie dann ab.
+// Was bis dahin noch zu initialisieren ist, laeuft waehrend der Wandlung.
+void Acq_Prime(void);
+uint8 Acq_GetMode(void);
+
+// Liefert das naechste UT/UP Paar mit Zeitstempeln. Im Pipeline Modus ist beim Ruecksprung
+// die Temperaturwandlung der naechsten Messung schon gestartet, die
+// Verarbeitung durch den Aufrufer laeuft also parallel zur Wandlung.
+void Acq_Next(Acq_Sample *sample);
+
+// Producer Seite: wie Acq_Next(), die Messung geht aber in die Queue. Der
+// Consumer (Acq_SetConsumer()) wird aus den Wartezeiten aufgerufen und
+// verarbeitet sie, waehrend die naechste Messung wandelt. Wandert die
+// Erfassung in eine ISR, bleibt die Consumer Seite gleich.
+struct SampleQ;
+void Acq_Produce(struct SampleQ *queue);
+void Acq_SetConsumer(void (*consume)(void));
+
+void Acq_ResetStats(void);
+uint32 Acq_SamplesPerSecondX100(void);
+
+#endif /* ACQ_H */
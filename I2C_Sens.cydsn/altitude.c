@@ -0,0 +1,151 @@
+#include "altitude.h"
+
+#define ALTITUDE_H_SCALE_CM 4433000     // 44330 m aus der barometrischen Hoehenformel
+
+// (ALTITUDE_P_MIN + i * 256) / 101325)^(1/5.255) * 2^30
+static const uint32 altitudeTable[ALTITUDE_TABLE_SIZE] =
+{
+    851747444, 853125800, 854494746, 855854423, 857204970, 858546524,
+    859879217, 861203178, 862518536, 863825413, 865123931, 866414208,
+    867696361, 868970503, 870236744, 871495195, 872745960, 873989144,
+    875224849, 876453175, 877674220, 878888078, 880094845, 881294612,
+    882487470, 883673505, 884852806, 886025457, 887191541, 888351140,
+    889504333, 890651200, 891791818, 892926262, 894054606, 895176923,
+    896293284, 897403761, 898508421, 899607332, 900700561, 901788173,
+    902870232, 903946801, 905017942, 906083716, 907144182, 908199399,
+    909249425, 910294317, 911334130, 912368919, 913398739, 914423642,
+    915443680, 916458904, 917469366, 918475115, 919476199, 920472667,
+    921464566, 922451942, 923434842, 924413310, 925387392, 926357129,
+    927322567, 928283747, 929240710, 930193498, 931142152, 932086711,
+    933027215, 933963702, 934896210, 935824778, 936749441, 937670237,
+    938587202, 939500371, 940409778, 941315459, 942217447, 943115776,
+    944010479, 944901588, 945789136, 946673153, 947553672, 948430724,
+    949304337, 950174544, 951041372, 951904851, 952765011, 953621879,
+    954475483, 955325852, 956173011, 957016990, 957857812, 958695507,
+    959530098, 960361611, 961190073, 962015507, 962837939, 963657392,
+    964473891, 965287459, 966098121, 966905898, 967710814, 968512891,
+    969312151, 970108618, 970902311, 971693253, 972481466, 973266969,
+    974049784, 974829932, 975607431, 976382303, 977154568, 977924244,
+    978691351, 979455908, 980217934, 980977448, 981734468, 982489012,
+    983241098, 983990745, 984737969, 985482789, 986225221, 986965282,
+    987702990, 988438361, 989171411, 989902157, 990630615, 991356800,
+    992080730, 992802418, 993521881, 994239134, 994954192, 995667070,
+    996377783, 997086346, 997792772, 998497077, 999199274, 999899377,
+    1000597402, 1001293360, 1001987266, 1002679133, 1003368975, 1004056805,
+    1004742635, 1005426479, 1006108350, 1006788261, 1007466223, 1008142249,
+    1008816352, 1009488544, 1010158837, 1010827242, 1011493773, 1012158439,
+    1012821254, 1013482228, 1014141373, 1014798700, 1015454220, 1016107944,
+    1016759884, 1017410050, 1018058453, 1018705104, 1019350013, 1019993190,
+    1020634646, 1021274391, 1021912436, 1022548790, 1023183464, 1023816466,
+    1024447808, 1025077499, 1025705548, 1026331965, 1026956760, 1027579941,
+    1028201518, 1028821500, 1029439897, 1030056717, 1030671970, 1031285664,
+    1031897807, 1032508410, 1033117480, 1033725026, 1034331056, 1034935579,
+    1035538604, 1036140138, 1036740189, 1037338767, 1037935878, 1038531532,
+    1039125735, 1039718496, 1040309823, 1040899722, 1041488203, 1042075272,
+    1042660938, 1043245207, 1043828086, 1044409585, 1044989709, 1045568465,
+    1046145862, 1046721906, 1047296605, 1047869964, 1048441992, 1049012695,
+    1049582080, 1050150153, 1050716922, 1051282393, 1051846573, 1052409468,
+    1052971085, 1053531431, 1054090511, 1054648332, 1055204900, 1055760223,
+    1056314305, 1056867153, 1057418774, 1057969173, 1058518356, 1059066329,
+    1059613099, 1060158670, 1060703050, 1061246244, 1061788257, 1062329095,
+    1062868764, 1063407270, 1063944618, 1064480814, 1065015863, 1065549771,
+    1066082542, 1066614184, 1067144700, 1067674096, 1068202378, 1068729550,
+    1069255618, 1069780588, 1070304463, 1070827249, 1071348952, 1071869576,
+    1072389127, 1072907608, 1073425026, 1073941384, 1074456689, 1074970943,
+    1075484154, 1075996324, 1076507459, 1077017563, 1077526642, 1078034699,
+    1078541739, 1079047767, 1079552788, 1080056805, 1080559823, 1081061847,
+    1081562881, 1082062930, 1082561997, 1083060087, 1083557204, 1084053352,
+    1084548537, 1085042761, 1085536029, 1086028345, 1086519714, 1087010138,
+    1087499623, 1087988173, 1088475790, 1088962480, 1089448247, 1089933093,
+    1090417023, 1090900042
+};
+
+static int32 altitudeP0 = ALTITUDE_P0_DEFAULT;
+static uint32 altitudeF0;       // f(p0) in Q30
+static uint32 altitudeScale;    // 4433000 * 2^30 / f(p0)
+
+
+// f(p) = (p / 101325)^(1/5.255) in Q30, linear interpoliert
+static uint32 Altitude_F(int32 p)
+{
+    uint32 offset;
+    uint32 i;
+
+    if (p < ALTITUDE_P_MIN)
+    {
+        p = ALTITUDE_P_MIN;
+    }
+    offset = (uint32)(p - ALTITUDE_P_MIN);
+    i = offset >> ALTITUDE_P_STEP_SHIFT;
+    if (i >= ALTITUDE_TABLE_SIZE - 1u)
+    {
+        return altitudeTable[ALTITUDE_TABLE_SIZE - 1u];
+    }
+
+    uint32 frac = offset & ((1u << ALTITUDE_P_STEP_SHIFT) - 1u);
+    return altitudeTable[i] + (((altitudeTable[i + 1u] - altitudeTable[i]) * frac) >> ALTITUDE_P_STEP_SHIFT);
+}
+
+// Umkehrung von Altitude_F() per Bisektion ueber die Tabelle
+static int32 Altitude_InverseF(uint32 f)
+{
+    uint32 lo = 0;
+    uint32 hi = ALTITUDE_TABLE_SIZE - 1u;
+
+    if (f <= altitudeTable[0])
+    {
+        return ALTITUDE_P_MIN;
+    }
+    if (f >= altitudeTable[hi])
+    {
+        return ALTITUDE_P_MIN + (int32)(hi << ALTITUDE_P_STEP_SHIFT);
+    }
+    while (hi - lo > 1u)
+    {
+        uint32 mid = (lo + hi) / 2u;
+        if (altitudeTable[mid] <= f)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    uint32 frac = ((f - altitudeTable[lo]) << ALTITUDE_P_STEP_SHIFT) / (altitudeTable[hi] - altitudeTable[lo]);
+    return ALTITUDE_P_MIN + (int32)((lo << ALTITUDE_P_STEP_SHIFT) + frac);
+}
+
+void Altitude_SetSeaLevel(int32 p0)
+{
+    altitudeP0 = p0;
+    altitudeF0 = Altitude_F(p0);
+    altitudeScale = (uint32)(((uint64)ALTITUDE_H_SCALE_CM << 30) / altitudeF0);
+}
+
+int32 Altitude_GetSeaLevel(void)
+{
+    return altitudeP0;
+}
+
+int32 Altitude_FromPressure(int32 p)
+{
+    if (altitudeF0 == 0)
+    {
+        Altitude_SetSeaLevel(altitudeP0);
+    }
+    // h = 44330 m * (1 - f(p) / f(p0))
+    return ALTITUDE_H_SCALE_CM - (int32)(((uint64)Altitude_F(p) * altitudeScale) >> 30);
+}
+
+int32 Altitude_SeaLevelPressure(int32 p, int32 altitudeCm)
+{
+    // f(p0) = f(p) / (1 - h / 44330 m)
+    int64 g = (int64)(1 << 30) - (((int64)altitudeCm << 30) / ALTITUDE_H_SCALE_CM);
+    if (g <= 0)
+    {
+        return 0;
+    }
+    return Altitude_InverseF((uint32)(((uint64)Altitude_F(p) << 30) / (uint64)g));
+}
@@ -0,0 +1,23 @@
+#ifndef ALTITUDE_H
+#define ALTITUDE_H
+
+#include "project.h"
+
+#define ALTITUDE_P0_DEFAULT 101325  // Normaldruck auf Meereshoehe in Pa
+
+// Tabelle von (p / 101325)^(1/5.255) in Q30 fuer 300 .. 1101 hPa, 256 Pa Raster.
+// Der Fehler inkl. Rundung bleibt damit unter 7 cm (bei 300 hPa), um 1000 hPa unter 1 cm.
+#define ALTITUDE_P_MIN      30000
+#define ALTITUDE_P_STEP_SHIFT 8
+#define ALTITUDE_TABLE_SIZE 314
+
+void Altitude_SetSeaLevel(int32 p0);
+int32 Altitude_GetSeaLevel(void);
+
+// Hoehe in cm ueber dem eingestellten Meereshoehendruck
+int32 Altitude_FromPressure(int32 p);
+
+// Meereshoehendruck in Pa bei bekannter Hoehe (cm) und gemessenem Druck (Pa)
+int32 Altitude_SeaLevelPressure(int32 p, int32 altitudeCm);
+
+#endif /* ALTITUDE_H */
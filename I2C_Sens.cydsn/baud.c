@@ -0,0 +1,106 @@
+#include "baud.h"
+#include "out.h"
+#include "perf.h"
+#include "timebase.h"
+#include "hal.h"
+
+static const uint32 baudRates[] = { 9600u, 19200u, 38400u, 57600u, 115200u, 230400u, 460800u, 921600u };
+
+static uint32 baudCurrent = BAUD_DEFAULT;  // Out_Idle() braucht sie auch vor Baud_Init()
+static uint32 baudFallback;
+static uint64 baudDeadline;
+static uint8 baudPending;
+
+
+void Baud_Init(void)
+{
+    baudCurrent = BAUD_DEFAULT;
+    baudPending = 0;
+}
+
+uint32 Baud_Divider(uint32 baud)
+{
+    return Baud_DividerAt(baud, PERF_CPU_HZ);
+}
+
+uint32 Baud_DividerAt(uint32 baud, uint32 clock)
+{
+    uint32 step = baud * UART_OVER_SAMPLE_COUNT;
+    uint32 divider;
+    uint32 actual;
+    uint32 error;
+    uint8 i;
+
+    for (i = 0; i < sizeof(baudRates) / sizeof(baudRates[0]); i++)
+    {
+        if (baudRates[i] == baud)
+        {
+            break;
+        }
+    }
+    if (i == sizeof(baudRates) / sizeof(baudRates[0]))
+    {
+        return 0;
+    }
+
+    divider = (clock + step / 2u) / step;
+    if ((divider == 0) || (divider > 65536u))
+    {
+        return 0;
+    }
+    actual = clock / (divider * UART_OVER_SAMPLE_COUNT);
+    error = (actual > baud) ? actual - baud : baud - actual;
+    if ((uint64)error * 1000000u > (uint64)baud * BAUD_MAX_ERROR_PPM)
+    {
+        return 0;
+    }
+    return divider;
+}
+
+uint8 Baud_Set(uint32 baud)
+{
+    uint32 divider = Baud_Divider(baud);
+
+    if (divider == 0)
+    {
+        return 0;
+    }
+
+    Out_Flush();
+    Hal_UartSetDivider((uint16)divider);
+    baudCurrent = baud;
+    return 1;
+}
+
+uint32 Baud_Get(void)
+{
+    return baudCurrent;
+}
+
+uint8 Baud_Request(uint32 baud)
+{
+    uint32 previous = baudCurrent;
+
+    if (!Baud_Set(baud))
+    {
+        return 0;
+    }
+    baudFallback = previous;
+    baudDeadline = Time_Us() + BAUD_CONFIRM_MS * 1000u;
+    baudPending = 1;
+    return 1;
+}
+
+void Baud_Confirm(void)
+{
+    baudPending = 0;
+}
+
+void Baud_Poll(void)
+{
+    if (baudPending && (Time_Us() >= baudDeadline))
+    {
+        baudPending = 0;
+        Baud_Set(baudFallback);
+    }
+}
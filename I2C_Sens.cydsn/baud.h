@@ -0,0 +1,35 @@
+#ifndef BAUD_H
+#define BAUD_H
+
+#include "project.h"
+
+// Baudrate zur Laufzeit ueber den Teiler von UART_IntClock (8 fach Oversampling,
+// Quelle Master Clock). Aushandeln mit dem Host ueber das Kommando BAUD:
+//
+//   Host -> Geraet:  "BAUD <rate>"   Antwort "OK" noch mit der alten Rate,
+//                                    danach schaltet das Geraet um
+//   Host -> Geraet:  "BAUD OK"       mit der neuen Rate, Antwort "OK"
+//
+// Kommt die Bestaetigung nicht innerhalb von BAUD_CONFIRM_MS, geht das Geraet
+// auf die vorherige Rate zurueck. Nach einem Reset gilt immer BAUD_DEFAULT.
+#define BAUD_DEFAULT        9600u
+#define BAUD_MAX_ERROR_PPM  20000u      // 2 %, mehr vertraegt die Gegenseite nicht sicher
+#define BAUD_CONFIRM_MS     2000u
+
+void Baud_Init(void);
+
+// Teiler (1..65536) fuer eine Standardrate, 0 wenn die Rate mit dem
+// aktuellen Takt nicht geht. Bei 24 MHz ist 230400 die hoechste Rate.
+uint32 Baud_Divider(uint32 baud);
+uint32 Baud_DividerAt(uint32 baud, uint32 clock);    // fuer einen anderen Takt (clock.h)
+
+// sofort umschalten, wartet vorher bis alles gesendet ist
+uint8 Baud_Set(uint32 baud);
+uint32 Baud_Get(void);
+
+// Umschalten mit Rueckfall, siehe oben
+uint8 Baud_Request(uint32 baud);
+void Baud_Confirm(void);
+void Baud_Poll(void);
+
+#endif /* BAUD_H */
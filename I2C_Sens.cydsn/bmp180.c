@@ -0,0 +1,397 @@
+#include "bmp180.h"
+#include "bus.h"
+#include "hal.h"
+
+// kalibrations variablen
+int16 AC1, AC2, AC3, B1, B2, MB, MC, MD;
+uint16 AC4, AC5, AC6;
+uint8 BMP180_oss;
+uint8 BMP180_calibrationRetained;
+
+BMP180_Coeffs BMP180_coeffs;
+
+#if BMP180_RETAIN_CALIBRATION
+typedef struct
+{
+    uint32 magic;
+    int16 ac1, ac2, ac3, b1, b2, mb, mc, md;
+    uint16 ac4, ac5, ac6;
+    uint32 check;
+} BMP180_Retained;
+
+CY_NOINIT static BMP180_Retained retained;
+#endif
+
+#if BMP180_FIXED_OSS == BMP180_OSS_RUNTIME
+// Druck Wandlungszeit je Oversampling laut Datenblatt
+static const uint8 presConvMs[BMP180_OSS_MAX + 1u] =
+{
+    BMP180_PRES_CONV_MS_OSS(0u), BMP180_PRES_CONV_MS_OSS(1u), BMP180_PRES_CONV_MS_OSS(2u), BMP180_PRES_CONV_MS_OSS(3u)
+};
+
+// Oversampling der vorberechneten Konstanten, bei festem OSS eine Konstante
+#define BMP180_COEFF_OSS(c) ((c)->oss)
+#else
+#define BMP180_COEFF_OSS(c) BMP180_FIXED_OSS
+#endif
+
+
+uint8 BMP180_errors;
+Bus_Device BMP180_device = { BMP180_ADDR, BUS_NO_MUX, 0 };
+
+
+// Fehler nur mitzaehlen, der Aufrufer prueft BMP180_errors pro Messung
+static void BMP180_Check(uint8 result)
+{
+    if (result != BUS_OK)
+    {
+        BMP180_errors++;
+    }
+}
+
+void BMP180_WriteByte(uint8 reg, uint8 value)
+{
+    uint8 data[2] = { reg, value };
+    BMP180_Check(Bus_DevWrite(&BMP180_device, data, 2));
+}
+
+uint16 BMP180_ReadWord(uint8 reg)
+{
+    uint8 data[2] = { 0, 0 };
+    BMP180_Check(Bus_DevReadReg(&BMP180_device, reg, data, 2));
+    return ((uint16)data[0] << 8) | data[1];
+}
+
+uint8 BMP180_ReadByte(uint8 reg)
+{
+    uint8 data = 0;
+    BMP180_Check(Bus_DevReadReg(&BMP180_device, reg, &data, 1));
+    return data;
+}
+
+
+void BMP180_ReadCalibrationData(void)
+{
+    AC1 = (int16)BMP180_ReadWord(0xAA);
+    AC2 = (int16)BMP180_ReadWord(0xAC);
+    AC3 = (int16)BMP180_ReadWord(0xAE);
+    AC4 = BMP180_ReadWord(0xB0);
+    AC5 = BMP180_ReadWord(0xB2);
+    AC6 = BMP180_ReadWord(0xB4);
+    B1  = (int16)BMP180_ReadWord(0xB6);
+    B2  = (int16)BMP180_ReadWord(0xB8);
+    MB  = (int16)BMP180_ReadWord(0xBA);
+    MC  = (int16)BMP180_ReadWord(0xBC);
+    MD  = (int16)BMP180_ReadWord(0xBE);
+}
+
+void BMP180_StartTemperature(void)
+{
+    BMP180_WriteByte(BMP180_REG_CTRL, BMP180_CMD_TEMP);
+}
+
+void BMP180_StartPressure(void)
+{
+    BMP180_WriteByte(BMP180_REG_CTRL, BMP180_CMD_PRES_OSS(BMP180_OSS));
+}
+
+uint16 BMP180_ReadResult(void)
+{
+    return BMP180_ReadWord(BMP180_REG_RESULT);
+}
+
+int32 BMP180_ReadPressureResult(void)
+{
+    uint8 data[3] = { 0, 0, 0 };
+
+    if (BMP180_OSS == 0)
+    {
+        return (int32)BMP180_ReadResult();
+    }
+
+    // MSB, LSB, XLSB in einem Zug
+    BMP180_Check(Bus_DevReadReg(&BMP180_device, BMP180_REG_RESULT, data, 3));
+
+    return (int32)((((uint32)data[0] << 16) | ((uint32)data[1] << 8) | data[2]) >> (8u - BMP180_OSS));
+}
+
+void BMP180_SetOss(uint8 oss)
+{
+#if BMP180_FIXED_OSS == BMP180_OSS_RUNTIME
+    BMP180_oss = (oss > BMP180_OSS_MAX) ? BMP180_OSS_MAX : oss;
+#else
+    (void)oss;
+    BMP180_oss = BMP180_FIXED_OSS;
+#endif
+    BMP180_PrepareCoeffs();
+}
+
+uint8 BMP180_PressureConvMs(void)
+{
+#if BMP180_FIXED_OSS == BMP180_OSS_RUNTIME
+    return presConvMs[BMP180_oss];
+#else
+    return BMP180_PRES_CONV_MS_OSS(BMP180_FIXED_OSS);
+#endif
+}
+
+// EOC Pin falls im TopDesign vorhanden (Pin Komponente "EOC"), sonst Sco Bit per I2C
+uint8 BMP180_ConversionDone(void)
+{
+#if HAL_HAS_EOC
+    return Hal_EocRead();
+#else
+    return (BMP180_ReadByte(BMP180_REG_CTRL) & BMP180_CTRL_SCO) == 0;
+#endif
+}
+
+int16 BMP180_ReadRawTemperature(void)
+{
+    BMP180_StartTemperature();
+    Hal_DelayMs(BMP180_TEMP_CONV_MS);
+    return BMP180_ReadResult();
+}
+
+int32 BMP180_ReadRawPressure(void)
+{
+    BMP180_StartPressure();
+    Hal_DelayMs(BMP180_PressureConvMs());
+    return BMP180_ReadPressureResult();
+}
+
+
+float BMP180_CalculateTemperature(int16 ut, int32 *B5)
+{
+    int32 X1 = (((int32)ut - AC6) * AC5) >> 15;
+    int32 X2 = ((int32)MC << 11) / (X1 + MD);
+    *B5 = X1 + X2;
+    float T = (((*B5 + 8) >> 4)) / 10.0;  // Temperature in °C
+    return T;
+}
+
+int32 BMP180_CalculatePressure(int32 up, int32 B5)
+{
+    int32 B6 = B5 - 4000;
+    int32 X1 = (B2 * ((B6 * B6) >> 12)) >> 11;
+    int32 X2 = (AC2 * B6) >> 11;
+    int32 X3 = X1 + X2;
+    int32 B3 = (((((int32)AC1) * 4 + X3) << BMP180_OSS) + 2) / 4;
+    X1 = (AC3 * B6) >> 13;
+    X2 = (B1 * ((B6 * B6) >> 12)) >> 16;
+    X3 = ((X1 + X2) + 2) >> 2;
+    uint32 B4 = (AC4 * (uint32)(X3 + 32768)) >> 15;
+    uint32 B7 = ((uint32)up - B3) * (50000 >> BMP180_OSS);
+    int32 P;
+    if (B7 < 0x80000000)
+    {
+        P = (B7 << 1) / B4;
+    }
+    else
+    {
+        P = (B7 / B4) << 1;
+    }
+    X1 = (P >> 8) * (P >> 8);
+    X1 = (X1 * 3038) >> 16;
+    X2 = (-7357 * P) >> 16;
+    P = P + ((X1 + X2 + 3791) >> 4);
+    return P;
+}
+
+void BMP180_PrepareCoeffs(void)
+{
+    BMP180_Coeffs *c = &BMP180_coeffs;
+    c->ac1 = (int32)AC1 * 4;
+    c->ac2 = AC2;
+    c->ac3 = AC3;
+    c->ac4 = AC4;
+    c->ac5 = AC5;
+    c->ac6 = AC6;
+    c->b1  = B1;
+    c->b2  = B2;
+    c->mc  = (int32)MC * 2048;
+    c->md  = MD;
+    c->oss = BMP180_OSS;
+}
+
+int32 BMP180_CalculateB5Fast(int16 ut)
+{
+    const BMP180_Coeffs *c = &BMP180_coeffs;
+    int32 X1 = ((ut - c->ac6) * c->ac5) >> 15;
+    return X1 + c->mc / (X1 + c->md);
+}
+
+void BMP180_PreparePressure(int32 B5, BMP180_PressureTerms *terms)
+{
+    const BMP180_Coeffs *c = &BMP180_coeffs;
+    int32 B6 = B5 - 4000;
+    int32 B6sq = (B6 * B6) >> 12;
+    int32 X3 = ((((c->ac3 * B6) >> 13) + ((c->b1 * B6sq) >> 16)) + 2) >> 2;
+    terms->B3 = (((c->ac1 + ((c->b2 * B6sq) >> 11) + ((c->ac2 * B6) >> 11)) << BMP180_COEFF_OSS(c)) + 2) / 4;
+    // AC4 * (X3 + 32768) >> 15 ohne die Addition im Produkt
+    terms->B4 = c->ac4 + (uint32)(((int32)c->ac4 * X3) >> 15);
+}
+
+static inline int32 BMP180_PressureFromTerms(int32 up, int32 B3, uint32 B4)
+{
+    uint32 B7 = ((uint32)up - B3) * (50000u >> BMP180_COEFF_OSS(&BMP180_coeffs));
+    int32 P;
+    if (B7 < 0x80000000)
+    {
+        P = (B7 << 1) / B4;
+    }
+    else
+    {
+        P = (B7 / B4) << 1;
+    }
+    int32 X1 = ((P >> 8) * (P >> 8) * 3038) >> 16;
+    int32 X2 = (-7357 * P) >> 16;
+    return P + ((X1 + X2 + 3791) >> 4);
+}
+
+void BMP180_CompensatePressureBatch(int32 B5, const int32 *up, int32 *pressure, uint32 count)
+{
+    BMP180_PressureTerms terms;
+    uint32 i;
+
+    BMP180_PreparePressure(B5, &terms);
+    for (i = 0; i < count; i++)
+    {
+        pressure[i] = BMP180_PressureFromTerms(up[i], terms.B3, terms.B4);
+    }
+}
+
+void BMP180_CompensateBatch(const int16 *ut, const int32 *up,
+                            int32 *temperature, int32 *pressure, uint32 count)
+{
+    BMP180_PressureTerms terms;
+    int32 B5 = 0;
+    int16 lastUt = 0;
+    uint32 i;
+
+    for (i = 0; i < count; i++)
+    {
+        // B5 und die davon abhaengigen Terme nur bei neuem UT neu rechnen
+        if ((i == 0) || (ut[i] != lastUt))
+        {
+            lastUt = ut[i];
+            B5 = BMP180_CalculateB5Fast(lastUt);
+            BMP180_PreparePressure(B5, &terms);
+        }
+        temperature[i] = BMP180_TemperatureX10(B5);
+        pressure[i] = BMP180_PressureFromTerms(up[i], terms.B3, terms.B4);
+    }
+}
+
+#if BMP180_BATCH_WIDE
+// ein Block Structure of Arrays: erst alle Terme aus UT, dann alle Druckwerte
+static void BMP180_CompensateBlock(const int16 *ut, const int32 *up,
+                                   int32 *temperature, int32 *pressure, uint32 count)
+{
+    const BMP180_Coeffs *c = &BMP180_coeffs;
+    const uint32 oss = BMP180_COEFF_OSS(c);
+    int32 B3[BMP180_BATCH_BLOCK];
+    uint32 B4[BMP180_BATCH_BLOCK];
+    uint32 i;
+
+    for (i = 0; i < count; i++)
+    {
+        int32 X1 = ((ut[i] - c->ac6) * c->ac5) >> 15;
+        // Abschneiden Richtung 0 wie bei der int32 Division
+        int32 B5 = X1 + (int32)((double)c->mc / (double)(X1 + c->md));
+        int32 B6 = B5 - 4000;
+        int32 B6sq = (B6 * B6) >> 12;
+        int32 X3 = ((((c->ac3 * B6) >> 13) + ((c->b1 * B6sq) >> 16)) + 2) >> 2;
+        temperature[i] = BMP180_TemperatureX10(B5);
+        B3[i] = (((c->ac1 + ((c->b2 * B6sq) >> 11) + ((c->ac2 * B6) >> 11)) << oss) + 2) / 4;
+        B4[i] = c->ac4 + (uint32)(((int32)c->ac4 * X3) >> 15);
+    }
+    for (i = 0; i < count; i++)
+    {
+        uint32 B7 = ((uint32)up[i] - B3[i]) * (50000u >> oss);
+        // beide Zweige der Datenblattformel: vor oder nach der Division verdoppeln
+        uint32 big = B7 >> 31;
+        uint32 q = (uint32)(int64)((double)((int64)B7 << (1u - big)) / (double)B4[i]);
+        int32 P = (int32)(q << big);
+        int32 X1 = ((P >> 8) * (P >> 8) * 3038) >> 16;
+        int32 X2 = (-7357 * P) >> 16;
+        pressure[i] = P + ((X1 + X2 + 3791) >> 4);
+    }
+}
+
+void BMP180_CompensateBatchWide(const int16 *ut, const int32 *up,
+                                int32 *temperature, int32 *pressure, uint32 count)
+{
+    while (count > 0)
+    {
+        uint32 n = (count > BMP180_BATCH_BLOCK) ? BMP180_BATCH_BLOCK : count;
+        BMP180_CompensateBlock(ut, up, temperature, pressure, n);
+        ut += n;
+        up += n;
+        temperature += n;
+        pressure += n;
+        count -= n;
+    }
+}
+#endif
+
+#if BMP180_RETAIN_CALIBRATION
+static uint32 BMP180_RetainedCheck(void)
+{
+    const uint16 *data = (const uint16 *)&retained.ac1;
+    uint32 sum = BMP180_RETAIN_MAGIC;
+    uint8 i;
+
+    for (i = 0; i < 11u; i++)
+    {
+        sum = ((sum << 5) | (sum >> 27)) ^ data[i];
+    }
+    return sum;
+}
+
+static uint8 BMP180_RestoreCalibration(void)
+{
+    if ((retained.magic != BMP180_RETAIN_MAGIC) || (retained.check != BMP180_RetainedCheck()))
+    {
+        return 0;
+    }
+    // anderer Sensor am Bus, oder der RAM Inhalt ist nur zufaellig gueltig
+    if ((int16)BMP180_ReadWord(0xAA) != retained.ac1)
+    {
+        return 0;
+    }
+    AC1 = retained.ac1; AC2 = retained.ac2; AC3 = retained.ac3;
+    AC4 = retained.ac4; AC5 = retained.ac5; AC6 = retained.ac6;
+    B1  = retained.b1;  B2  = retained.b2;
+    MB  = retained.mb;  MC  = retained.mc;  MD  = retained.md;
+    return 1;
+}
+
+static void BMP180_RetainCalibration(void)
+{
+    retained.ac1 = AC1; retained.ac2 = AC2; retained.ac3 = AC3;
+    retained.ac4 = AC4; retained.ac5 = AC5; retained.ac6 = AC6;
+    retained.b1  = B1;  retained.b2  = B2;
+    retained.mb  = MB;  retained.mc  = MC;  retained.md  = MD;
+    retained.check = BMP180_RetainedCheck();
+    retained.magic = BMP180_RETAIN_MAGIC;
+}
+#endif
+
+void BMP180_Init(void)
+{
+#if BMP180_RETAIN_CALIBRATION
+    BMP180_calibrationRetained = BMP180_RestoreCalibration();
+    if (!BMP180_calibrationRetained)
+    {
+        uint8 errors = BMP180_errors;
+        BMP180_ReadCalibrationData();
+        if (errors == BMP180_errors)
+        {
+            BMP180_RetainCalibration();
+        }
+    }
+#else
+    BMP180_ReadCalibrationData();
+#endif
+    BMP180_PrepareCoeffs();
+}
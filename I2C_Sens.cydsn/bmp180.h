@@ -0,0 +1,147 @@
+#ifndef BMP180_H
+#define BMP180_H
+
+#include "project.h"
+#include "bus.h"
+
+#define BMP180_ADDR 0x77  // BMP180 I2C addresse
+
+#define BMP180_REG_CTRL     0xF4
+#define BMP180_REG_RESULT   0xF6
+
+#define BMP180_CMD_TEMP     0x2E
+#define BMP180_CMD_PRES     0x34
+
+#define BMP180_CTRL_SCO     0x20    // Start of conversion, 0 sobald fertig
+#define BMP180_OSS_SHIFT    6       // Oversampling Bits im Steuerregister
+#define BMP180_OSS_MAX      3u
+
+// worst case Wandlungszeiten laut Datenblatt (Druck fuer OSS = 0)
+#define BMP180_TEMP_CONV_MS 5
+#define BMP180_PRES_CONV_MS 8
+#define BMP180_PRES_CONV_MS_OSS(oss)    (((oss) <= 1u) ? BMP180_PRES_CONV_MS : ((oss) == 2u) ? 14u : 26u)
+#define BMP180_CMD_PRES_OSS(oss)        (BMP180_CMD_PRES | ((oss) << BMP180_OSS_SHIFT))
+
+// Oversampling fest zur Uebersetzungszeit: mit BMP180_FIXED_OSS 0..3 werden
+// Steuerbyte, Wandlungszeit und alle Schiebeweiten der Kompensation zu
+// Konstanten und BMP180_SetOss() bzw. das Kommando OSS nehmen nur noch diesen
+// Wert an. BMP180_OSS_RUNTIME laesst es wie bisher einstellbar.
+#define BMP180_OSS_RUNTIME  0xFFu
+#define BMP180_FIXED_OSS    BMP180_OSS_RUNTIME
+
+#if BMP180_FIXED_OSS == BMP180_OSS_RUNTIME
+#define BMP180_OSS          BMP180_oss
+#else
+#define BMP180_OSS          BMP180_FIXED_OSS
+#endif
+
+// ungueltige Konfiguration faellt schon beim Uebersetzen auf
+typedef char BMP180_CheckOss[((BMP180_FIXED_OSS <= BMP180_OSS_MAX) || (BMP180_FIXED_OSS == BMP180_OSS_RUNTIME)) ? 1 : -1];
+typedef char BMP180_CheckAddr[((BMP180_ADDR >= 0x08) && (BMP180_ADDR <= 0x77) && (BMP180_ADDR != BUS_MUX_ADDR)) ? 1 : -1];
+
+// kalibrations variablen
+extern int16 AC1, AC2, AC3, B1, B2, MB, MC, MD;
+extern uint16 AC4, AC5, AC6;
+
+// Oversampling fuer die Druckmessung (0..3), nur ueber BMP180_SetOss() aendern
+extern uint8 BMP180_oss;
+
+// Kopie der Kalibrierung in nicht initialisiertem RAM. Ueberlebt Soft Reset
+// und Watchdog, nach Pruefsumme und Vergleich von AC1 mit dem Sensor spart
+// BMP180_Init() damit 10 der 11 Kalibrier Lesezugriffe.
+#define BMP180_RETAIN_CALIBRATION   1
+#define BMP180_RETAIN_MAGIC         0xB180CA1Bu
+
+extern uint8 BMP180_calibrationRetained;    // 1: letzte Init kam ohne Neulesen aus
+
+// fehlgeschlagene Buszugriffe (siehe bus.h), laeuft frei ueber
+extern uint8 BMP180_errors;
+
+// Pfad zum Sensor, vor BMP180_Init() per Bus_Bind() hinter einen Mux legen
+extern Bus_Device BMP180_device;
+
+// aus den Kalibrationswerten vorberechnete Konstanten fuer die schnelle Kompensation
+typedef struct
+{
+    int32 ac1;      // AC1 * 4
+    int32 ac2;
+    int32 ac3;
+    uint32 ac4;
+    int32 ac5;
+    int32 ac6;
+    int32 b1;
+    int32 b2;
+    int32 mc;       // MC << 11
+    int32 md;
+    uint8 oss;
+} BMP180_Coeffs;
+
+extern BMP180_Coeffs BMP180_coeffs;
+
+void BMP180_Init(void);     // Bus_Init() muss vorher gelaufen sein
+void BMP180_WriteByte(uint8 reg, uint8 value);
+uint16 BMP180_ReadWord(uint8 reg);
+uint8 BMP180_ReadByte(uint8 reg);
+void BMP180_ReadCalibrationData(void);
+
+// Wandlung starten bzw. Ergebnis abholen, ohne zu warten
+void BMP180_StartTemperature(void);
+void BMP180_StartPressure(void);
+uint16 BMP180_ReadResult(void);
+uint8 BMP180_ConversionDone(void);
+int32 BMP180_ReadPressureResult(void);     // UP mit 16 + oss Bit
+
+// Oversampling setzen, rechnet auch BMP180_coeffs neu
+void BMP180_SetOss(uint8 oss);
+uint8 BMP180_PressureConvMs(void);
+
+int16 BMP180_ReadRawTemperature(void);
+int32 BMP180_ReadRawPressure(void);
+
+float BMP180_CalculateTemperature(int16 ut, int32 *B5);
+int32 BMP180_CalculatePressure(int32 up, int32 B5);
+
+// B5 bitgenau zu BMP180_CalculateTemperature(), aber ohne float und mit
+// BMP180_coeffs statt der Rohwerte. Der Druck kommt fuer einzelne Werte aus
+// BMP180_CalculatePressure(), vorberechnet lohnt sich erst im Batch.
+void BMP180_PrepareCoeffs(void);
+int32 BMP180_CalculateB5Fast(int16 ut);
+
+// nur von B5 abhaengige Zwischenwerte der Druckberechnung
+typedef struct
+{
+    int32 B3;
+    uint32 B4;
+} BMP180_PressureTerms;
+
+void BMP180_PreparePressure(int32 B5, BMP180_PressureTerms *terms);
+
+// Kompensation ganzer Rohwert Puffer (Structure of Arrays), z.B. beim Log Dump.
+// Temperatur in 0.1 °C, Druck in Pa. Gleiche UT Werte hintereinander teilen B5.
+void BMP180_CompensateBatch(const int16 *ut, const int32 *up,
+                            int32 *temperature, int32 *pressure, uint32 count);
+// mehrere Druckwerte zu einer gemeinsamen Temperaturmessung
+void BMP180_CompensatePressureBatch(int32 B5, const int32 *up, int32 *pressure, uint32 count);
+
+// 1: BMP180_CompensateBatchWide(), gleiche Ergebnisse wie BMP180_CompensateBatch(),
+// aber in Bloecken ohne Sprung und mit den beiden Divisionen ueber double
+// (Dividend < 2^33, Quotient also exakt). So vektorisiert der Compiler auf
+// einem PC mit SIMD beide Schleifen; auf dem M3 ohne FPU ist es langsamer,
+// dort bleibt es aus.
+#ifndef BMP180_BATCH_WIDE
+#define BMP180_BATCH_WIDE   0
+#endif
+#define BMP180_BATCH_BLOCK  256u
+
+#if BMP180_BATCH_WIDE
+void BMP180_CompensateBatchWide(const int16 *ut, const int32 *up,
+                                int32 *temperature, int32 *pressure, uint32 count);
+#endif
+
+// Temperatur in 0.1 °C
+static inline int32 BMP180_TemperatureX10(int32 B5)
+{
+    return (B5 + 8) >> 4;
+}
+
+#endif /* BMP180_H */
@@ -0,0 +1,48 @@
+#include "boot.h"
+#include "bmp180.h"
+#include "out.h"
+#include "perf.h"
+#include "fmt.h"
+
+static const char *const bootNames[BOOT_PHASES] = { "main", "sensor", "trigger", "init", "first sample" };
+
+static uint32 bootCycles[BOOT_PHASES];
+static uint8 bootSeen;
+
+
+// so frueh wie moeglich, laeuft ueber __libc_init_array() vor main()
+__attribute__((constructor))
+static void Boot_Start(void)
+{
+    Perf_Init();
+}
+
+void Boot_Mark(uint8 phase)
+{
+    if (!(bootSeen & (1u << phase)))
+    {
+        bootCycles[phase] = Perf_Cycles();
+        bootSeen |= (uint8)(1u << phase);
+    }
+}
+
+uint8 Boot_Done(void)
+{
+    return bootSeen == ((1u << BOOT_PHASES) - 1u);
+}
+
+void Boot_Report(void)
+{
+    char buffer[80];
+    uint8 i;
+
+    for (i = 0; i < BOOT_PHASES; i++)
+    {
+        if (bootSeen & (1u << i))
+        {
+            Fmt_Print(buffer, "Boot: %s %lu us%s\r\n", bootNames[i], Perf_CyclesToUs(bootCycles[i]),
+                      ((i == BOOT_SENSOR) && BMP180_calibrationRetained) ? " (calibration retained)" : "");
+            Out_Print(buffer);
+        }
+    }
+}
@@ -0,0 +1,22 @@
+#ifndef BOOT_H
+#define BOOT_H
+
+#include "project.h"
+
+// Zeitstempel der Startphasen in DWT Takten. Der Zaehler startet in einem
+// Konstruktor nach initialize_psoc(), die Konfiguration aus cyfitter_cfg.c
+// davor ist also nicht mitgezaehlt.
+#define BOOT_MAIN           0u  // main() erreicht
+#define BOOT_SENSOR         1u  // I2C laeuft, Kalibrierung da
+#define BOOT_TRIGGER        2u  // erste Wandlung gestartet
+#define BOOT_INIT           3u  // restliche Initialisierung im Schatten der Wandlung
+#define BOOT_FIRST_SAMPLE   4u  // erste Messung gelesen
+#define BOOT_PHASES         5u
+
+void Boot_Mark(uint8 phase);
+uint8 Boot_Done(void);          // alle Phasen erreicht
+
+// "Boot: ..." Zeilen ueber Out, Zeiten in us seit dem Konstruktor
+void Boot_Report(void);
+
+#endif /* BOOT_H */
@@ -0,0 +1,287 @@
+#include "bus.h"
+#include "perf.h"
+#include "hal.h"
+#if BUS_TRACE
+#include "trace.h"
+#endif
+
+#define BUS_CONTENTION  0xFFu       // intern: nochmal versuchen
+
+Bus_Stats Bus_stats;
+Bus_ChannelStats Bus_channelStats[BUS_MAX_MUX][BUS_MUX_CHANNELS];
+
+static uint32 busSeed;
+static uint8 muxAddr[BUS_MAX_MUX];
+static uint8 muxSelected[BUS_MAX_MUX];  // zuletzt geschriebenes Steuerbyte
+static uint8 muxCount;
+
+
+// xorshift32, reicht um zwei Master auseinander zu bringen
+static uint32 Bus_Random(void)
+{
+    busSeed ^= busSeed << 13;
+    busSeed ^= busSeed >> 17;
+    busSeed ^= busSeed << 5;
+    return busSeed;
+}
+
+static void Bus_Backoff(uint8 attempt)
+{
+    uint32 window = BUS_BACKOFF_US << attempt;
+    uint32 us;
+
+    if (window > BUS_BACKOFF_MAX_US)
+    {
+        window = BUS_BACKOFF_MAX_US;
+    }
+    us = 1u + (Bus_Random() % window);
+    Bus_stats.backoffUs += us;
+    Hal_DelayUs((uint16)us);
+}
+
+// Ergebnis einer gestarteten Teil-Transaktion abwarten
+static uint8 Bus_Wait(uint8 start, uint8 doneMask)
+{
+    uint8 status;
+
+    if (start == I2C_MSTR_BUS_BUSY)
+    {
+        Bus_stats.busy++;
+        return BUS_CONTENTION;
+    }
+    if (start == I2C_MSTR_ERR_ARB_LOST)
+    {
+        Bus_stats.arbLost++;
+        return BUS_CONTENTION;
+    }
+    if (start != I2C_MSTR_NO_ERROR)
+    {
+        // Master steckt noch in einer halben Transaktion
+        return BUS_CONTENTION;
+    }
+
+    // nach NO_STOP bleibt XFER_INP gesetzt, dort zaehlt XFER_HALT als fertig
+    do
+    {
+        status = Hal_I2CStatus();
+    } while ((status & (I2C_MSTAT_XFER_INP | I2C_MSTAT_XFER_HALT)) == I2C_MSTAT_XFER_INP);
+
+    if (status & I2C_MSTAT_ERR_ARB_LOST)
+    {
+        Bus_stats.arbLost++;
+        return BUS_CONTENTION;
+    }
+    if (status & I2C_MSTAT_ERR_ADDR_NAK)
+    {
+        return BUS_ERR_NAK;
+    }
+    if ((status & I2C_MSTAT_ERR_MASK) || !(status & doneMask))
+    {
+        return BUS_CONTENTION;
+    }
+    return BUS_OK;
+}
+
+static uint8 Bus_Attempt(uint8 addr, const uint8 *wr, uint8 wrLen, uint8 *rd, uint8 rdLen)
+{
+    uint8 result = BUS_OK;
+
+    Hal_I2CClearStatus();
+    if (wrLen > 0)
+    {
+        result = Bus_Wait(Hal_I2CWrite(addr, (uint8 *)wr, wrLen,
+                                       (rdLen > 0) ? I2C_MODE_NO_STOP : I2C_MODE_COMPLETE_XFER),
+                          (rdLen > 0) ? I2C_MSTAT_XFER_HALT : I2C_MSTAT_WR_CMPLT);
+#if BUS_TRACE
+        Trace_Record(addr, 0, wr, wrLen, result);
+#endif
+    }
+    if ((result == BUS_OK) && (rdLen > 0))
+    {
+        Hal_I2CClearStatus();
+        result = Bus_Wait(Hal_I2CRead(addr, rd, rdLen,
+                                      (wrLen > 0) ? I2C_MODE_REPEAT_START : I2C_MODE_COMPLETE_XFER),
+                          I2C_MSTAT_RD_CMPLT);
+#if BUS_TRACE
+        Trace_Record(addr, TRACE_READ, rd, rdLen, result);
+#endif
+    }
+    if ((result != BUS_OK) && (Hal_I2CStatus() & I2C_MSTAT_XFER_HALT))
+    {
+        // nach NO_STOP haelt der Master den Bus noch, freigeben
+        Hal_I2CStop();
+    }
+    return result;
+}
+
+static uint8 Bus_Transaction(uint8 addr, const uint8 *wr, uint8 wrLen, uint8 *rd, uint8 rdLen)
+{
+    uint8 attempt;
+    uint8 result;
+
+    Bus_stats.transactions++;
+    for (attempt = 0; ; attempt++)
+    {
+        result = Bus_Attempt(addr, wr, wrLen, rd, rdLen);
+        if (result != BUS_CONTENTION)
+        {
+            break;
+        }
+        if (attempt >= BUS_RETRIES)
+        {
+            Bus_stats.failures++;
+            return BUS_ERR_CONTENTION;
+        }
+        Bus_stats.retries++;
+        Bus_Backoff(attempt);
+    }
+    if (result == BUS_ERR_NAK)
+    {
+        Bus_stats.naks++;
+        Bus_stats.failures++;
+    }
+    return result;
+}
+
+void Bus_Init(void)
+{
+    Bus_stats.transactions = 0;
+    Bus_stats.busy = 0;
+    Bus_stats.arbLost = 0;
+    Bus_stats.retries = 0;
+    Bus_stats.naks = 0;
+    Bus_stats.failures = 0;
+    Bus_stats.backoffUs = 0;
+    // jeder Master soll eine andere Folge haben
+    busSeed = Perf_Cycles() | 1u;
+    muxCount = 0;
+#if BUS_TRACE
+    Trace_Init();
+#endif
+    Hal_I2CStart();
+}
+
+uint8 Bus_Write(uint8 addr, const uint8 *data, uint8 len)
+{
+    return Bus_Transaction(addr, data, len, NULL, 0);
+}
+
+uint8 Bus_Read(uint8 addr, uint8 *data, uint8 len)
+{
+    return Bus_Transaction(addr, NULL, 0, data, len);
+}
+
+uint8 Bus_ReadReg(uint8 addr, uint8 reg, uint8 *data, uint8 len)
+{
+    return Bus_Transaction(addr, &reg, 1, data, len);
+}
+
+uint8 Bus_AddMux(uint8 addr)
+{
+    uint8 i;
+
+    if (muxCount >= BUS_MAX_MUX)
+    {
+        return BUS_NO_MUX;
+    }
+    muxAddr[muxCount] = addr;
+    muxSelected[muxCount] = 0;
+    for (i = 0; i < BUS_MUX_CHANNELS; i++)
+    {
+        Bus_ChannelStats *stats = &Bus_channelStats[muxCount][i];
+        stats->transactions = 0;
+        stats->bytes = 0;
+        stats->cycles = 0;
+        stats->selects = 0;
+    }
+    // nach einem Reset des Controllers kann noch ein Kanal offen sein
+    Bus_Write(addr, &muxSelected[muxCount], 1);
+    return muxCount++;
+}
+
+uint8 Bus_MuxCount(void)
+{
+    return muxCount;
+}
+
+void Bus_Bind(Bus_Device *device, uint8 addr, uint8 mux, uint8 channel)
+{
+    device->addr = addr;
+    device->mux = (mux < muxCount) ? mux : BUS_NO_MUX;
+    device->channel = channel % BUS_MUX_CHANNELS;
+}
+
+static uint8 Bus_SetMux(uint8 mux, uint8 control)
+{
+    uint8 result;
+
+    if (muxSelected[mux] == control)
+    {
+        return BUS_OK;
+    }
+    result = Bus_Write(muxAddr[mux], &control, 1);
+    // bei Fehler ist der Zustand unbekannt, beim naechsten Mal sicher neu schreiben
+    muxSelected[mux] = (result == BUS_OK) ? control : 0xFFu;
+    return result;
+}
+
+static uint8 Bus_Select(const Bus_Device *device)
+{
+    uint8 control = (uint8)(1u << device->channel);
+    uint8 i;
+
+    if (device->mux == BUS_NO_MUX)
+    {
+        return BUS_OK;
+    }
+    if (muxSelected[device->mux] == control)
+    {
+        return BUS_OK;
+    }
+    for (i = 0; i < muxCount; i++)
+    {
+        if ((i != device->mux) && (muxSelected[i] != 0) && (Bus_SetMux(i, 0) != BUS_OK))
+        {
+            return BUS_ERR_CONTENTION;
+        }
+    }
+    Bus_channelStats[device->mux][device->channel].selects++;
+    return Bus_SetMux(device->mux, control);
+}
+
+static void Bus_Account(const Bus_Device *device, uint8 bytes, uint32 start)
+{
+    if (device->mux != BUS_NO_MUX)
+    {
+        Bus_ChannelStats *stats = &Bus_channelStats[device->mux][device->channel];
+        stats->transactions++;
+        stats->bytes += bytes;
+        stats->cycles += Perf_Cycles() - start;
+    }
+}
+
+uint8 Bus_DevWrite(const Bus_Device *device, const uint8 *data, uint8 len)
+{
+    uint32 start = Perf_Cycles();
+    uint8 result = Bus_Select(device);
+
+    if (result == BUS_OK)
+    {
+        result = Bus_Write(device->addr, data, len);
+    }
+    Bus_Account(device, len, start);
+    return result;
+}
+
+uint8 Bus_DevReadReg(const Bus_Device *device, uint8 reg, uint8 *data, uint8 len)
+{
+    uint32 start = Perf_Cycles();
+    uint8 result = Bus_Select(device);
+
+    if (result == BUS_OK)
+    {
+        result = Bus_ReadReg(device->addr, reg, data, len);
+    }
+    Bus_Account(device, (uint8)(len + 1u), start);
+    return result;
+}
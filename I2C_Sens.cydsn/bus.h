@@ -0,0 +1,90 @@
+#ifndef BUS_H
+#define BUS_H
+
+#include "project.h"
+
+// I2C Transaktionen fuer geteilte Busse. Ist der Bus belegt oder geht die
+// Arbitrierung verloren (I2C_MSTAT_ERR_ARB_LOST, nur wenn die I2C Komponente
+// auf Multi-Master steht), wird die ganze Transaktion nach einer zufaelligen
+// Wartezeit wiederholt. Das Wartefenster verdoppelt sich pro Versuch bis
+// BUS_BACKOFF_MAX_US, nach BUS_RETRIES Wiederholungen wird aufgegeben.
+// Registerzugriffe laufen mit Repeated Start, damit kein anderer Master
+// zwischen Registeradresse und Lesen auf den Sensor zugreift.
+#define BUS_RETRIES         6u
+#define BUS_BACKOFF_US      64u
+#define BUS_BACKOFF_MAX_US  2048u
+
+// 1: jeden Teil-Transfer in trace.h mitschneiden
+#define BUS_TRACE           1
+
+#define BUS_OK              0u
+#define BUS_ERR_NAK         1u      // Slave antwortet nicht, keine Wiederholung
+#define BUS_ERR_CONTENTION  2u      // Bus nach allen Versuchen nicht bekommen
+
+typedef struct
+{
+    uint32 transactions;
+    uint32 busy;            // Bus war beim Start belegt
+    uint32 arbLost;
+    uint32 retries;
+    uint32 naks;
+    uint32 failures;        // Transaktionen, die aufgegeben wurden
+    uint32 backoffUs;       // Summe der Wartezeiten
+} Bus_Stats;
+
+extern Bus_Stats Bus_stats;
+
+// I2C Multiplexer (TCA9548A: ein Steuerbyte, Bit n = Kanal n offen). Geraete
+// haengen an einem Pfad (Mux, Kanal). Der Mux wird nur umgeschaltet, wenn sich
+// der Pfad gegenueber dem letzten Zugriff aendert; wer Zugriffe nach Pfad
+// sortiert (Bus_PathKey()), zahlt also einen Umschaltvorgang pro Gruppe.
+// Beim Wechsel auf einen anderen Mux wird der bisherige geschlossen.
+// Geraete ohne Mux (BUS_NO_MUX) liegen direkt am Bus und muessen eine
+// Adresse haben, die hinter keinem Mux nochmal vorkommt.
+//
+// Ohne Mux Hardware: HAL_SIM bildet Muxe samt Sensoren hinter den Kanaelen
+// nach (hal.h), test/test_bus.c prueft damit Umschalten und Statistik.
+#define BUS_MUX_ADDR        0x70u   // TCA9548A mit A0..A2 = 0
+#define BUS_MAX_MUX         2u
+#define BUS_MUX_CHANNELS    8u
+#define BUS_NO_MUX          0xFFu
+
+typedef struct
+{
+    uint8 addr;
+    uint8 mux;                  // Index aus Bus_AddMux() oder BUS_NO_MUX
+    uint8 channel;
+} Bus_Device;
+
+typedef struct
+{
+    uint32 transactions;
+    uint32 bytes;               // Nutzdaten ohne Adressbytes
+    uint32 cycles;              // Zeit in den Transaktionen
+    uint32 selects;             // Umschaltvorgaenge auf diesen Kanal
+} Bus_ChannelStats;
+
+extern Bus_ChannelStats Bus_channelStats[BUS_MAX_MUX][BUS_MUX_CHANNELS];
+
+void Bus_Init(void);
+uint8 Bus_Write(uint8 addr, const uint8 *data, uint8 len);
+uint8 Bus_Read(uint8 addr, uint8 *data, uint8 len);
+// Registeradresse schreiben, dann mit Repeated Start len Bytes lesen
+uint8 Bus_ReadReg(uint8 addr, uint8 reg, uint8 *data, uint8 len);
+
+// Mux anmelden, gibt den Index zurueck oder BUS_NO_MUX wenn kein Platz mehr ist
+uint8 Bus_AddMux(uint8 addr);
+uint8 Bus_MuxCount(void);
+void Bus_Bind(Bus_Device *device, uint8 addr, uint8 mux, uint8 channel);
+
+// wie oben, aber vorher den Pfad zum Geraet schalten
+uint8 Bus_DevWrite(const Bus_Device *device, const uint8 *data, uint8 len);
+uint8 Bus_DevReadReg(const Bus_Device *device, uint8 reg, uint8 *data, uint8 len);
+
+// Sortierschluessel: gleiche Pfade liegen nebeneinander, direkte Geraete zuletzt
+static inline uint8 Bus_PathKey(const Bus_Device *device)
+{
+    return (device->mux == BUS_NO_MUX) ? 0xFFu : (uint8)((device->mux * BUS_MUX_CHANNELS) + device->channel);
+}
+
+#endif /* BUS_H */
@@ -0,0 +1,182 @@
+#include "clock.h"
+
+#if CLOCK_GOVERNOR
+#include "perf.h"
+#include "timebase.h"
+#include "baud.h"
+#include "out.h"
+#include "rx.h"
+#include "hal.h"
+#include "fmt.h"
+
+// Teiler der Master Clock minus 1: 6, 24 und 48 MHz
+static const uint8 clockDivider[CLOCK_POINTS] = { 7u, 1u, 0u };
+
+typedef char Clock_CheckNominal[((CLOCK_PLL_HZ / 2u) == BCLK__BUS_CLK__HZ) ? 1 : -1];
+
+Clock_Stats Clock_stats;
+
+static uint8 clockPoint;
+static uint8 clockPending;      // Ziel eines verschobenen Wechsels, CLOCK_POINTS = keiner
+static uint64 clockSince;
+
+
+uint32 Clock_Hz(uint8 point)
+{
+    return CLOCK_PLL_HZ / (clockDivider[point] + 1u);
+}
+
+uint8 Clock_Get(void)
+{
+    return clockPoint;
+}
+
+// Flash Wartezyklen nach MHz, aufgerundet
+static void Clock_WaitCycles(uint32 hz)
+{
+    CyFlash_SetWaitCycles((uint8)((hz + 999999u) / 1000000u));
+}
+
+static void Clock_Apply(uint8 point, uint16 uartDivider)
+{
+    uint32 hz = Clock_Hz(point);
+    uint32 i2cDivider = (hz + (16u * CLOCK_I2C_HZ) - 1u) / (16u * CLOCK_I2C_HZ);
+    uint8 interruptState = CyEnterCriticalSection();
+
+    // schneller: erst Wartezyklen, langsamer: danach
+    if (hz > PERF_CPU_HZ)
+    {
+        Clock_WaitCycles(hz);
+    }
+    // UART Teiler gleich hinterher, damit der Baudratentakt nur ein paar
+    // Befehle lang falsch ist
+    CyMasterClk_SetDivider(clockDivider[point]);
+    Hal_UartRetune(uartDivider);
+    if (hz < PERF_CPU_HZ)
+    {
+        Clock_WaitCycles(hz);
+    }
+    CyDelayFreq(hz);
+    Perf_SetHz(hz);
+    Time_SetClock(hz);
+    Hal_I2CSetDivider((uint16)i2cDivider);
+    CyExitCriticalSection(interruptState);
+}
+
+void Clock_Init(void)
+{
+    uint8 i;
+
+    // waehrend die PLL neu einrastet laeuft alles direkt vom IMO
+    CyMasterClk_SetSource(CY_MASTER_SOURCE_IMO);
+    CyPLL_OUT_Stop();
+    CyPLL_OUT_SetPQ(CLOCK_PLL_P, 1u, CLOCK_PLL_CURRENT);
+    if (CyPLL_OUT_Start(1u) != CYRET_SUCCESS)
+    {
+        // rastet nicht ein, ohne PLL stimmen UART und I2C Teiler nicht
+        CyHalt(0u);
+    }
+    Clock_WaitCycles(BCLK__BUS_CLK__HZ);
+    CyMasterClk_SetDivider(clockDivider[CLOCK_NOMINAL]);
+    CyMasterClk_SetSource(CY_MASTER_SOURCE_PLL);
+
+    clockPoint = CLOCK_NOMINAL;
+    clockPending = CLOCK_POINTS;
+    for (i = 0; i < CLOCK_POINTS; i++)
+    {
+        Clock_stats.us[i] = 0;
+    }
+    Clock_stats.switches = 0;
+    Clock_stats.deferred = 0;
+    clockSince = 0;
+}
+
+uint8 Clock_Set(uint8 point)
+{
+    uint32 uartDivider;
+    uint64 now;
+
+    // den naechsten Arbeitspunkt Richtung NOMINAL nehmen, auf dem die Baudrate geht
+    for (;;)
+    {
+        if (point == clockPoint)
+        {
+            clockPending = CLOCK_POINTS;
+            return 1;
+        }
+        uartDivider = Baud_DividerAt(Baud_Get(), Clock_Hz(point));
+        if (uartDivider != 0)
+        {
+            break;
+        }
+        if (point == CLOCK_NOMINAL)
+        {
+            return 0;
+        }
+        point = (point < CLOCK_NOMINAL) ? point + 1u : point - 1u;
+    }
+
+    // auch das letzte Byte muss das Schieberegister verlassen haben, und es
+    // darf keine Zeile halb empfangen sein. Gezaehlt wird jeder verschobene
+    // Wechsel einmal, nicht jeder Versuch.
+    if (!Out_Idle() || !Rx_Idle())
+    {
+        if (clockPending != point)
+        {
+            clockPending = point;
+            Clock_stats.deferred++;
+        }
+        return 0;
+    }
+    clockPending = CLOCK_POINTS;
+
+    now = Time_Us();
+    Clock_stats.us[clockPoint] += now - clockSince;
+    clockSince = now;
+    Clock_Apply(point, (uint16)uartDivider);
+    clockPoint = point;
+    Clock_stats.switches++;
+    return 1;
+}
+
+void Clock_Report(void)
+{
+    char buffer[80];
+    uint64 now = Time_Us();
+    uint32 ms[CLOCK_POINTS];
+    uint8 i;
+
+    for (i = 0; i < CLOCK_POINTS; i++)
+    {
+        ms[i] = (uint32)((Clock_stats.us[i] + ((i == clockPoint) ? now - clockSince : 0u)) / 1000u);
+    }
+    Fmt_Print(buffer, "Stats: clock %lu/%lu/%lu MHz %lu/%lu/%lu ms, switches %lu, deferred %lu\r\n",
+              Clock_Hz(CLOCK_LOW) / 1000000u, Clock_Hz(CLOCK_NOMINAL) / 1000000u, Clock_Hz(CLOCK_HIGH) / 1000000u,
+              ms[CLOCK_LOW], ms[CLOCK_NOMINAL], ms[CLOCK_HIGH], Clock_stats.switches, Clock_stats.deferred);
+    Out_Print(buffer);
+}
+#else
+void Clock_Init(void)
+{
+}
+
+uint8 Clock_Set(uint8 point)
+{
+    return point == CLOCK_NOMINAL;
+}
+
+uint8 Clock_Get(void)
+{
+    return CLOCK_NOMINAL;
+}
+
+uint32 Clock_Hz(uint8 point)
+{
+    (void)point;
+    return BCLK__BUS_CLK__HZ;
+}
+
+void Clock_Report(void)
+{
+}
+#endif
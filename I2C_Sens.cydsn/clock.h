@@ -0,0 +1,67 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include "project.h"
+#include "config.h"
+
+// Arbeitspunkte fuer CPU und Bustakt, nur mit CLOCK_GOVERNOR in config.h.
+// Die PLL laeuft fest auf CLOCK_PLL_HZ, umgeschaltet wird nur der Teiler der
+// Master Clock. Dazu passend werden Flash Wartezyklen, CyDelayFreq(), SysTick
+// (timebase.h), PERF_CPU_HZ sowie die Teiler von UART und I2C nachgezogen.
+//
+// Hochgeschaltet wird fuer Kompensation, Formatierung und Log Ausgabe
+// (Clock_Boost() nach jeder Messung), heruntergeschaltet waehrend der
+// Wandlungen (Clock_Idle() aus den Wartezeiten in acq.c).
+//
+// Ein Wechsel verstellt kurz den UART Takt. Umgeschaltet wird deshalb nur,
+// wenn nichts mehr gesendet wird (Out_Idle()) und keine Zeile halb empfangen
+// ist (Rx_Idle()), sonst bleibt der alte Arbeitspunkt und Clock_stats.deferred
+// zaehlt den Wechsel einmal. Arbeitspunkte, auf denen die eingestellte
+// Baudrate nicht genau genug geht (baud.h), werden uebersprungen.
+#define CLOCK_LOW           0u
+#define CLOCK_NOMINAL       1u      // wie im Clock DWR, BCLK__BUS_CLK__HZ
+#define CLOCK_HIGH          2u
+#define CLOCK_POINTS        3u
+
+#define CLOCK_IMO_HZ        3000000u
+#define CLOCK_PLL_P         16u     // 3 MHz * 16 = 48 MHz
+#define CLOCK_PLL_HZ        (CLOCK_IMO_HZ * CLOCK_PLL_P)
+#define CLOCK_PLL_CURRENT   2u
+#define CLOCK_I2C_HZ        100000u
+
+typedef struct
+{
+    uint64 us[CLOCK_POINTS];    // Zeit je Arbeitspunkt
+    uint32 switches;
+    uint32 deferred;            // Wechsel wegen laufender Ausgabe/Eingabe verschoben
+} Clock_Stats;
+
+extern Clock_Stats Clock_stats;
+
+// PLL auf CLOCK_PLL_HZ, danach CLOCK_NOMINAL. Als erstes in main(), vor
+// Time_Init(), Bus_Init() und Out_Init().
+void Clock_Init(void);
+
+// 1 wenn der Arbeitspunkt jetzt gilt, bzw. der naechste in Richtung
+// CLOCK_NOMINAL, falls die Baudrate auf ihm nicht geht
+uint8 Clock_Set(uint8 point);
+uint8 Clock_Get(void);
+uint32 Clock_Hz(uint8 point);
+
+static inline void Clock_Boost(void)
+{
+#if CLOCK_GOVERNOR
+    (void)Clock_Set(CLOCK_HIGH);
+#endif
+}
+
+static inline void Clock_Idle(void)
+{
+#if CLOCK_GOVERNOR
+    (void)Clock_Set(CLOCK_LOW);
+#endif
+}
+
+void Clock_Report(void);
+
+#endif /* CLOCK_H */
@@ -0,0 +1,263 @@
+#include "cmd.h"
+#include "acq.h"
+#include "bmp180.h"
+#include "out.h"
+#include "fmt.h"
+#include "baud.h"
+#include "log.h"
+#include "trace.h"
+
+static uint32 cmdBaud;          // angefragte Rate, gilt erst nach der Antwort
+
+
+// prueft, ob *line mit dem Wort word beginnt, und ueberspringt es samt Leerzeichen
+static uint8 Cmd_Word(const char **line, const char *word)
+{
+    const char *s = *line;
+    while (*word)
+    {
+        if (*s++ != *word++)
+        {
+            return 0;
+        }
+    }
+    if ((*s != ' ') && (*s != '\0'))
+    {
+        return 0;
+    }
+    while (*s == ' ')
+    {
+        s++;
+    }
+    *line = s;
+    return 1;
+}
+
+static uint8 Cmd_Number(const char **line, uint32 max, uint32 *value)
+{
+    uint64 v;
+    if (!Fmt_ParseU64(line, &v) || (v > max))
+    {
+        return 0;
+    }
+    *value = (uint32)v;
+    return 1;
+}
+
+// "M5 I2 ..", ungueltige Stufen verwerfen die ganze Kette
+static uint8 Cmd_Filter(const char *line, Settings_Stage *stage)
+{
+    Settings_Stage parsed[FILTER_MAX_STAGES];
+    uint8 n = 0;
+    uint8 i;
+
+    while (*line != '\0')
+    {
+        uint8 type;
+        uint32 param;
+
+        switch (*line++)
+        {
+        case 'M': type = FILTER_MEDIAN; break;
+        case 'B': type = FILTER_BOXCAR; break;
+        case 'I': type = FILTER_IIR; break;
+        default: return 0;
+        }
+        if ((n >= FILTER_MAX_STAGES) || !Cmd_Number(&line, FILTER_WINDOW_MAX, &param))
+        {
+            return 0;
+        }
+        if (!Settings_StageValid(type, param))
+        {
+            return 0;
+        }
+        parsed[n].type = type;
+        parsed[n].param = (uint8)param;
+        n++;
+        while (*line == ' ')
+        {
+            line++;
+        }
+    }
+
+    for (i = 0; i < FILTER_MAX_STAGES; i++)
+    {
+        stage[i].type = (i < n) ? parsed[i].type : FILTER_NONE;
+        stage[i].param = (i < n) ? parsed[i].param : 0;
+    }
+    return 1;
+}
+
+static uint8 Cmd_Parse(const char *line, Settings *settings, uint16 *apply)
+{
+    uint32 value;
+
+    if (Cmd_Word(&line, "PERIOD"))
+    {
+        if (!Cmd_Number(&line, 0xFFFFFFFFu / 1000u, &value))
+        {
+            return 0;
+        }
+        settings->periodUs = value * 1000u;
+        *apply = CMD_APPLY_ACQ;
+    }
+    else if (Cmd_Word(&line, "MODE"))
+    {
+        if (Cmd_Word(&line, "SEQ"))
+        {
+            settings->mode = ACQ_MODE_SEQUENTIAL;
+        }
+        else if (Cmd_Word(&line, "PIPE"))
+        {
+            settings->mode = ACQ_MODE_PIPELINED;
+        }
+        else
+        {
+            return 0;
+        }
+        *apply = CMD_APPLY_ACQ;
+    }
+    else if (Cmd_Word(&line, "OSS"))
+    {
+        if (!Cmd_Number(&line, BMP180_OSS_MAX, &value) || !Settings_OssValid(value))
+        {
+            return 0;
+        }
+        settings->oss = (uint8)value;
+        *apply = CMD_APPLY_OSS;
+    }
+    else if (Cmd_Word(&line, "FILTER"))
+    {
+        Settings_Stage *stage;
+        if (Cmd_Word(&line, "P"))
+        {
+            stage = settings->pressure;
+        }
+        else if (Cmd_Word(&line, "T"))
+        {
+            stage = settings->temp;
+        }
+        else
+        {
+            return 0;
+        }
+        *apply = CMD_APPLY_FILTER;
+        return Cmd_Filter(line, stage);
+    }
+    else if (Cmd_Word(&line, "DECIM"))
+    {
+        if (!Cmd_Number(&line, 255u, &value) || (value == 0))
+        {
+            return 0;
+        }
+        settings->decimation = (uint8)value;
+        *apply = CMD_APPLY_FILTER;
+    }
+    else if (Cmd_Word(&line, "FORMAT"))
+    {
+        if (Cmd_Word(&line, "ASCII"))
+        {
+            settings->format = OUTPUT_FORMAT_ASCII;
+        }
+        else if (Cmd_Word(&line, "BIN"))
+        {
+            settings->format = OUTPUT_FORMAT_BINARY;
+        }
+        else
+        {
+            return 0;
+        }
+        *apply = CMD_APPLY_FORMAT;
+    }
+    else if (Cmd_Word(&line, "LOG"))
+    {
+        *apply = CMD_DUMP_LOG;
+    }
+    else if (Cmd_Word(&line, "STATS"))
+    {
+        *apply = CMD_DUMP_STATS;
+    }
+    else if (Cmd_Word(&line, "MEM"))
+    {
+        *apply = CMD_DUMP_MEM;
+    }
+    else if (Cmd_Word(&line, "BOOT"))
+    {
+        *apply = CMD_DUMP_BOOT;
+    }
+    else if (Cmd_Word(&line, "BAUD"))
+    {
+        if (Cmd_Word(&line, "OK"))
+        {
+            Baud_Confirm();
+        }
+        else if (!Cmd_Number(&line, 0xFFFFFFFFu, &cmdBaud) || (Baud_Divider(cmdBaud) == 0) ||
+                 Log_Dumping() || Trace_Dumping())
+        {
+            cmdBaud = 0;
+            return 0;
+        }
+    }
+    else if (Cmd_Word(&line, "TRACE"))
+    {
+        if (Trace_Dumping())
+        {
+            return 0;
+        }
+        if (Cmd_Word(&line, "ON"))
+        {
+            Trace_capture = 1;
+        }
+        else if (Cmd_Word(&line, "OFF"))
+        {
+            Trace_capture = 0;
+        }
+        else if (Cmd_Word(&line, "CLEAR"))
+        {
+            Trace_Clear();
+        }
+        else
+        {
+            *apply = CMD_DUMP_TRACE;
+        }
+    }
+    else if (Cmd_Word(&line, "SAVE"))
+    {
+        return Settings_Save(settings);
+    }
+    else
+    {
+        return 0;
+    }
+
+    // nichts Unerwartetes hinter dem Kommando
+    while (*line == ' ')
+    {
+        line++;
+    }
+    return *line == '\0';
+}
+
+uint16 Cmd_Handle(const char *line, Settings *settings)
+{
+    Settings changed = *settings;
+    uint16 apply = 0;
+
+    cmdBaud = 0;
+    if (*line == '\0')
+    {
+        return 0;
+    }
+    if (Cmd_Parse(line, &changed, &apply))
+    {
+        *settings = changed;
+        Out_Print("OK\r\n");
+        if (cmdBaud != 0)
+        {
+            Baud_Request(cmdBaud);
+        }
+        return apply;
+    }
+    Out_Print("ERR\r\n");
+    return 0;
+}
@@ -0,0 +1,38 @@
+#ifndef CMD_H
+#define CMD_H
+
+#include "project.h"
+#include "settings.h"
+
+// Textkommandos ueber die UART, eine Zeile pro Kommando, Antwort OK bzw. ERR:
+//
+//   PERIOD <ms>            Messabstand, 0 = freilaufend
+//   MODE SEQ|PIPE          sequentiell oder Temperaturwandlung vorziehen
+//   OSS <0..3>             Oversampling der Druckmessung
+//   FILTER P|T [stufe ..]  Filterkette neu, Stufen M<n> Median, B<n> Boxcar,
+//                          I<k> IIR, z.B. "FILTER P M5 I2"; ohne Stufe = aus
+//   DECIM <n>              nur jeder n-te gefilterte Wert geht raus
+//   FORMAT ASCII|BIN       Ausgabeformat
+//   LOG                    Rohwert Log senden (siehe log.h)
+//   STATS                  Statistik sofort senden
+//   MEM                    Stack/Heap Verbrauch senden (mem.h)
+//   BOOT                   Zeiten der Startphasen senden (boot.h)
+//   SAVE                   Einstellungen im Em_EEPROM ablegen
+//   BAUD <rate> | BAUD OK  Baudrate aushandeln, siehe baud.h
+//   TRACE [ON|OFF|CLEAR]   I2C Mitschnitt senden bzw. steuern (trace.h)
+//
+// Cmd_Handle() aendert nur *settings; was neu angewendet werden muss, steht
+// im Rueckgabewert. Das Anwenden macht der Aufrufer zwischen zwei Messungen.
+#define CMD_APPLY_ACQ       0x01u   // Periode, Modus
+#define CMD_APPLY_OSS       0x02u
+#define CMD_APPLY_FILTER    0x04u   // Filterketten, Dezimierung
+#define CMD_APPLY_FORMAT    0x08u
+#define CMD_DUMP_LOG        0x10u
+#define CMD_DUMP_STATS      0x20u
+#define CMD_DUMP_MEM        0x40u
+#define CMD_DUMP_BOOT       0x80u
+#define CMD_DUMP_TRACE      0x100u
+
+uint16 Cmd_Handle(const char *line, Settings *settings);
+
+#endif /* CMD_H */
@@ -0,0 +1,303 @@
+#include "codec.h"
+#include <string.h>
+
+#define CODEC_END_0         0x80u
+#define CODEC_END_1         0x00u
+#define CODEC_CRC_INIT      0xFFFFu
+
+#define CODEC_MORE          0u
+#define CODEC_BLOCK         1u
+#define CODEC_FAIL          2u
+
+
+// CRC-16/CCITT, bitweise: ein paar Bytes pro Messung, keine Tabelle im Flash
+static uint16_t Codec_Crc(uint16_t crc, const uint8_t *data, uint16_t len)
+{
+    uint8_t bit;
+
+    while (len--)
+    {
+        crc ^= (uint16_t)(*data++ << 8);
+        for (bit = 0; bit < 8u; bit++)
+        {
+            crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint8_t Codec_PutVarint(uint8_t *out, uint32_t value)
+{
+    uint8_t n = 0;
+    while (value >= 0x80u)
+    {
+        out[n++] = (uint8_t)(value | 0x80u);
+        value >>= 7;
+    }
+    out[n++] = (uint8_t)value;
+    return n;
+}
+
+static inline uint32_t Codec_ZigZag(int32_t value)
+{
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static inline int32_t Codec_UnZigZag(uint32_t value)
+{
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1u);
+}
+
+void Codec_InitEncoder(Codec_Encoder *enc, uint8_t channels, uint8_t keyInterval, uint8_t order2)
+{
+    enc->channels = (channels > CODEC_MAX_CHANNELS) ? CODEC_MAX_CHANNELS : channels;
+    enc->keyInterval = (keyInterval == 0) ? 1u
+                     : (keyInterval > CODEC_MAX_KEY_INTERVAL) ? CODEC_MAX_KEY_INTERVAL : keyInterval;
+    enc->order2 = order2;
+    enc->count = 0;
+    enc->seq = 0;
+    enc->bytes = 0;
+    enc->records = 0;
+}
+
+void Codec_ForceKeyframe(Codec_Encoder *enc)
+{
+    enc->count = 0;
+}
+
+static uint8_t Codec_Close(Codec_Encoder *enc, uint8_t *out)
+{
+    if (enc->count == 0)
+    {
+        return 0;
+    }
+    out[0] = CODEC_END_0;
+    out[1] = CODEC_END_1;
+    enc->crc = Codec_Crc(enc->crc, out, 2);
+    out[2] = (uint8_t)enc->crc;
+    out[3] = (uint8_t)(enc->crc >> 8);
+    enc->count = 0;
+    return CODEC_TRAILER;
+}
+
+uint8_t Codec_Flush(Codec_Encoder *enc, uint8_t *out)
+{
+    uint8_t n = Codec_Close(enc, out);
+    enc->bytes += n;
+    return n;
+}
+
+uint8_t Codec_Encode(Codec_Encoder *enc, const int32_t *values, uint8_t *out)
+{
+    uint8_t n = 0;
+    uint8_t i;
+
+    if (enc->count == 0)
+    {
+        out[n++] = CODEC_SYNC;
+        n += Codec_PutVarint(&out[n], enc->seq);
+        for (i = 0; i < enc->channels; i++)
+        {
+            n += Codec_PutVarint(&out[n], Codec_ZigZag(values[i]));
+            enc->slope[i] = 0;
+        }
+        enc->crc = CODEC_CRC_INIT;
+    }
+    else
+    {
+        for (i = 0; i < enc->channels; i++)
+        {
+            int32_t delta = (int32_t)((uint32_t)values[i] - (uint32_t)enc->prev[i]);
+            if (enc->order2 & (1u << i))
+            {
+                n += Codec_PutVarint(&out[n], Codec_ZigZag((int32_t)((uint32_t)delta - (uint32_t)enc->slope[i])));
+                enc->slope[i] = delta;
+            }
+            else
+            {
+                n += Codec_PutVarint(&out[n], Codec_ZigZag(delta));
+            }
+        }
+    }
+    enc->crc = Codec_Crc(enc->crc, out, n);
+
+    for (i = 0; i < enc->channels; i++)
+    {
+        enc->prev[i] = values[i];
+    }
+    enc->seq++;
+    if (++enc->count >= enc->keyInterval)
+    {
+        n += Codec_Close(enc, &out[n]);
+    }
+    enc->bytes += n;
+    enc->records++;
+    return n;
+}
+
+void Codec_InitDecoder(Codec_Decoder *dec, uint8_t channels, uint8_t keyInterval, uint8_t order2,
+                       Codec_RecordFn record, void *context)
+{
+    dec->channels = (channels > CODEC_MAX_CHANNELS) ? CODEC_MAX_CHANNELS : channels;
+    dec->keyInterval = (keyInterval == 0) ? 1u
+                     : (keyInterval > CODEC_MAX_KEY_INTERVAL) ? CODEC_MAX_KEY_INTERVAL : keyInterval;
+    dec->order2 = order2;
+    dec->tail = 0;
+    dec->length = 0;
+    dec->record = record;
+    dec->context = context;
+    dec->blocks = 0;
+    dec->records = 0;
+    dec->rejected = 0;
+    dec->skipped = 0;
+}
+
+// Varint ab *pos, hoechstens 5 Bytes und nicht ueber end hinaus
+static uint8_t Codec_GetVarint(const uint8_t *raw, uint16_t *pos, uint16_t end, uint32_t *value)
+{
+    uint32_t acc = 0;
+    uint8_t shift;
+
+    for (shift = 0; (shift <= 28u) && (*pos < end); shift += 7u)
+    {
+        uint8_t byte = raw[(*pos)++];
+        acc |= (uint32_t)(byte & 0x7Fu) << shift;
+        if (!(byte & 0x80u))
+        {
+            *value = acc;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Block in raw zerlegen. emit 0: nur pruefen, 1: Datensaetze herausgeben
+static uint8_t Codec_Parse(Codec_Decoder *dec, uint8_t emit)
+{
+    uint16_t end = (uint16_t)(dec->length - CODEC_TRAILER);
+    uint16_t pos = 1;
+    uint32_t seq;
+    uint32_t value;
+    int32_t delta;
+    int32_t values[CODEC_MAX_CHANNELS];
+    int32_t slope[CODEC_MAX_CHANNELS];
+    uint8_t count = 0;
+    uint8_t i;
+
+    if (!Codec_GetVarint(dec->raw, &pos, end, &seq))
+    {
+        return 0;
+    }
+    while (pos < end)
+    {
+        if (count >= dec->keyInterval)
+        {
+            return 0;
+        }
+        for (i = 0; i < dec->channels; i++)
+        {
+            if (!Codec_GetVarint(dec->raw, &pos, end, &value))
+            {
+                return 0;
+            }
+            if (count == 0)
+            {
+                values[i] = Codec_UnZigZag(value);
+                slope[i] = 0;
+                continue;
+            }
+            delta = Codec_UnZigZag(value);
+            if (dec->order2 & (1u << i))
+            {
+                delta = (int32_t)((uint32_t)delta + (uint32_t)slope[i]);
+                slope[i] = delta;
+            }
+            values[i] = (int32_t)((uint32_t)values[i] + (uint32_t)delta);
+        }
+        if (emit && (dec->record != 0))
+        {
+            dec->record(dec->context, seq + count, values);
+        }
+        count++;
+    }
+    if (emit)
+    {
+        dec->records += count;
+    }
+    return count > 0;
+}
+
+static uint8_t Codec_Collect(Codec_Decoder *dec, uint8_t byte)
+{
+    uint16_t crc;
+
+    if (dec->length == 0)
+    {
+        if (byte != CODEC_SYNC)
+        {
+            dec->skipped++;
+            return CODEC_MORE;
+        }
+        dec->tail = 0;
+    }
+    dec->raw[dec->length++] = byte;
+    if (dec->length > CODEC_MAX_BLOCK)
+    {
+        return CODEC_FAIL;
+    }
+    if (dec->tail > 0)
+    {
+        if (--dec->tail > 0)
+        {
+            return CODEC_MORE;
+        }
+        crc = Codec_Crc(CODEC_CRC_INIT, dec->raw, (uint16_t)(dec->length - 2u));
+        if ((dec->raw[dec->length - 2u] != (uint8_t)crc) || (dec->raw[dec->length - 1u] != (uint8_t)(crc >> 8)) ||
+            !Codec_Parse(dec, 0))
+        {
+            return CODEC_FAIL;
+        }
+        Codec_Parse(dec, 1);
+        dec->blocks++;
+        dec->length = 0;
+        return CODEC_BLOCK;
+    }
+    if ((dec->length >= 3u) && (dec->raw[dec->length - 2u] == CODEC_END_0) && (byte == CODEC_END_1))
+    {
+        dec->tail = 2;
+    }
+    return CODEC_MORE;
+}
+
+void Codec_Decode(Codec_Decoder *dec, uint8_t byte)
+{
+    uint8_t pending[CODEC_MAX_BLOCK + 1u];
+    uint16_t n = 1;
+    uint16_t i = 0;
+
+    pending[0] = byte;
+    while (i < n)
+    {
+        if (Codec_Collect(dec, pending[i++]) == CODEC_FAIL)
+        {
+            // alles nach dem vermeintlichen Sync nochmal, vor den restlichen Bytes
+            uint16_t rest = (uint16_t)(n - i);
+            uint16_t again = (uint16_t)(dec->length - 1u);
+            memmove(&pending[again], &pending[i], rest);
+            memcpy(pending, &dec->raw[1], again);
+            n = (uint16_t)(again + rest);
+            i = 0;
+            dec->length = 0;
+            dec->rejected++;
+        }
+    }
+}
+
+uint32_t Codec_BytesPerRecordX100(const Codec_Encoder *enc)
+{
+    if (enc->records == 0)
+    {
+        return 0;
+    }
+    return (uint32_t)(((uint64_t)enc->bytes * 100u) / enc->records);
+}
@@ -0,0 +1,86 @@
+#ifndef CODEC_H
+#define CODEC_H
+
+#include <stdint.h>
+
+// Delta + ZigZag + Varint Kodierung fuer Messwertstroeme.
+//
+// Ein Block:
+//     CODEC_SYNC, varint(seq), zigzag varint(Wert) je Kanal      Keyframe
+//     zigzag varint(Wert - vorheriger Wert) je Kanal             bis keyInterval - 1 mal
+//     0x80 0x00, CRC-16 little endian                            Blockende
+// 0x80 0x00 ist eine nicht minimale Null, die als Varint nie vorkommt, und
+// markiert das Ende unabhaengig von der Anzahl Datensaetze. Die CRC
+// (CCITT, 0xFFFF) laeuft vom Sync Byte bis einschliesslich 0x00.
+//
+// Kanaele mit gesetztem Bit in order2 (Bit i = Kanal i) uebertragen statt der
+// Differenz deren Aenderung gegenueber der vorigen Differenz. Fuer gleichmaessig
+// steigende Werte wie Zeitstempel bleibt das ein Byte, wo die einfache
+// Differenz zwei braucht. Die erste Differenz nach dem Keyframe ist einfach.
+//
+// Der Decoder gibt Datensaetze erst heraus, wenn der ganze Block samt CRC
+// stimmt. Fehlt ein Byte, ist eins verfaelscht oder steckt Text im Strom,
+// wird der Block verworfen und ab dem Byte nach dem vermeintlichen Sync neu
+// gesucht; ein 0xA5 in den Daten fuehrt so hoechstens zu einem verworfenen
+// Versuch. Zeilen in ASCII (< 0x80) koennen nie wie ein Sync aussehen.
+//
+// Nur <stdint.h>, kein project.h: dieselben Dateien bauen auf dem Host den
+// Decoder (test/codec_decode.c).
+#define CODEC_SYNC              0xA5u
+#define CODEC_MAX_CHANNELS      4u
+#define CODEC_MAX_KEY_INTERVAL  32u
+#define CODEC_TRAILER           4u
+#define CODEC_MAX_RECORD        (1u + 5u + (5u * CODEC_MAX_CHANNELS) + CODEC_TRAILER)
+#define CODEC_MAX_BLOCK         (1u + 5u + (5u * CODEC_MAX_CHANNELS * CODEC_MAX_KEY_INTERVAL) + CODEC_TRAILER)
+
+typedef struct
+{
+    uint8_t channels;
+    uint8_t keyInterval;
+    uint8_t order2;                     // Kanaele mit zweiter Differenz
+    uint8_t count;                      // Datensaetze im offenen Block, 0 = keiner offen
+    uint16_t crc;
+    uint32_t seq;
+    int32_t prev[CODEC_MAX_CHANNELS];
+    int32_t slope[CODEC_MAX_CHANNELS];  // letzte Differenz, nur order2
+    uint32_t bytes;                     // Statistik: erzeugte Bytes
+    uint32_t records;
+} Codec_Encoder;
+
+// wird fuer jeden Datensatz eines gueltigen Blocks aufgerufen
+typedef void (*Codec_RecordFn)(void *context, uint32_t seq, const int32_t *values);
+
+typedef struct
+{
+    uint8_t channels;
+    uint8_t keyInterval;
+    uint8_t order2;
+    uint8_t tail;                       // noch erwartete CRC Bytes nach 0x80 0x00
+    uint16_t length;                    // Bytes des laufenden Blocks in raw
+    uint8_t raw[CODEC_MAX_BLOCK + 1u];
+    Codec_RecordFn record;
+    void *context;
+    uint32_t blocks;                    // gueltige Bloecke
+    uint32_t records;
+    uint32_t rejected;                  // verworfene Blockversuche
+    uint32_t skipped;                   // Bytes ausserhalb von Bloecken, z.B. Text
+} Codec_Decoder;
+
+void Codec_InitEncoder(Codec_Encoder *enc, uint8_t channels, uint8_t keyInterval, uint8_t order2);
+// Schreibt hoechstens CODEC_MAX_RECORD Bytes nach out, gibt die Laenge zurueck
+uint8_t Codec_Encode(Codec_Encoder *enc, const int32_t *values, uint8_t *out);
+// offenen Block abschliessen (hoechstens CODEC_TRAILER Bytes), z.B. vor Text
+// im gleichen Strom oder vor dem Auslesen. Der naechste Datensatz ist ein Keyframe.
+uint8_t Codec_Flush(Codec_Encoder *enc, uint8_t *out);
+// offenen Block ohne Abschluss aufgeben, wenn seine Bytes verworfen wurden.
+// Der Decoder verwirft ihn ebenfalls.
+void Codec_ForceKeyframe(Codec_Encoder *enc);
+
+void Codec_InitDecoder(Codec_Decoder *dec, uint8_t channels, uint8_t keyInterval, uint8_t order2,
+                       Codec_RecordFn record, void *context);
+void Codec_Decode(Codec_Decoder *dec, uint8_t byte);
+
+// Bytes pro Datensatz x100
+uint32_t Codec_BytesPerRecordX100(const Codec_Encoder *enc);
+
+#endif /* CODEC_H */
@@ -0,0 +1,31 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+// Alle statisch angelegten Puffer an einer Stelle. Zusammen mit dem Stack
+// (CYDEV_STACK_SIZE) ergibt das den kompletten RAM Bedarf, zur Laufzeit
+// nachzupruefen mit dem Kommando MEM.
+
+// 1: kein Heap und kein stdio. _sbrk() haelt beim ersten Aufruf an und
+// Fmt_Print() ersetzt sprintf(), siehe fmt.h und mem.c
+#define CONFIG_HEAP_FREE    1
+
+// 1: CPU Takt zur Laufzeit umschalten (clock.h). PERF_CPU_HZ wird dann eine
+// Variable, Zeitmessungen in Takten gelten nur innerhalb eines Arbeitspunkts.
+#define CLOCK_GOVERNOR      0
+
+#define OUT_BUFFER_SIZE     256u    // UART Sendering
+#define RX_BUFFER_SIZE      96u     // UART Empfangsring, je Zeile 9 Byte mehr fuer die Empfangszeit
+#define RX_LINE_MAX         48u     // laengste Kommandozeile inkl. '\0'
+#define SAMPLEQ_SIZE        32u     // Messwerte zwischen Erfassung und Verarbeitung, Zweierpotenz
+#define LOG_SIZE            4096u   // Rohwert Log in Bytes
+#define TRACE_SIZE          1024u   // I2C Mitschnitt in Bytes, Zweierpotenz
+#define FILTER_MAX_STAGES   3u      // Stufen je Filterkette
+#define FILTER_WINDOW_MAX   16u     // laengstes Median/Boxcar Fenster
+
+// Groessen pruefen, die sonst erst zur Laufzeit auffallen
+typedef char Config_SampleQPow2[((SAMPLEQ_SIZE & (SAMPLEQ_SIZE - 1u)) == 0u) ? 1 : -1];
+typedef char Config_LogSize[(LOG_SIZE <= 65535u) ? 1 : -1];
+typedef char Config_TracePow2[(((TRACE_SIZE & (TRACE_SIZE - 1u)) == 0u) && (TRACE_SIZE <= 32768u)) ? 1 : -1];
+typedef char Config_OutSize[(OUT_BUFFER_SIZE <= 65535u) ? 1 : -1];
+
+#endif /* CONFIG_H */
@@ -0,0 +1,135 @@
+#include "filter.h"
+
+
+static int32 Filter_Iir(Filter_Stage *s, int32 in)
+{
+    int32 x = in * (1 << FILTER_IIR_FRAC);
+    if (s->count == 0)
+    {
+        s->acc = x;
+        s->count = 1;
+    }
+    else
+    {
+        s->acc += (x - s->acc) >> s->param;
+    }
+    return (s->acc + (1 << (FILTER_IIR_FRAC - 1))) >> FILTER_IIR_FRAC;
+}
+
+static int32 Filter_Boxcar(Filter_Stage *s, int32 in)
+{
+    if (s->count < s->param)
+    {
+        s->window[s->count++] = in;
+        s->acc += in;
+        return s->acc / s->count;
+    }
+    s->acc += in - s->window[s->pos];
+    s->window[s->pos] = in;
+    s->pos = (s->pos + 1u) % s->param;
+    return s->acc / s->param;
+}
+
+// Fenster bleibt sortiert, pro Wert ein Entfernen und ein Einfuegen, beides O(N)
+static int32 Filter_Median(Filter_Stage *s, int32 in)
+{
+    uint8 n = s->count;
+    uint8 i;
+
+    if (n == s->param)
+    {
+        int32 old = s->window[s->pos];
+        for (i = 0; s->sorted[i] != old; i++);
+        for (; i + 1u < n; i++)
+        {
+            s->sorted[i] = s->sorted[i + 1u];
+        }
+        n--;
+        s->window[s->pos] = in;
+        s->pos = (s->pos + 1u) % s->param;
+    }
+    else
+    {
+        s->window[n] = in;
+    }
+
+    for (i = n; (i > 0) && (s->sorted[i - 1u] > in); i--)
+    {
+        s->sorted[i] = s->sorted[i - 1u];
+    }
+    s->sorted[i] = in;
+    s->count = n + 1u;
+
+    return s->sorted[s->count / 2u];
+}
+
+void Filter_Init(Filter_Chain *chain, uint8 decimation)
+{
+    chain->stages = 0;
+    chain->decimation = (decimation > 0) ? decimation : 1u;
+    chain->phase = 0;
+}
+
+uint8 Filter_AddStage(Filter_Chain *chain, uint8 type, uint8 param)
+{
+    if ((chain->stages >= FILTER_MAX_STAGES) || (type == FILTER_NONE) || (type > FILTER_BOXCAR))
+    {
+        return 0;
+    }
+    if ((type == FILTER_IIR) ? (param > FILTER_IIR_MAX_K)
+                             : ((param == 0) || (param > FILTER_WINDOW_MAX)))
+    {
+        return 0;
+    }
+
+    Filter_Stage *s = &chain->stage[chain->stages++];
+    s->type = type;
+    s->param = param;
+    s->count = 0;
+    s->pos = 0;
+    s->acc = 0;
+    return 1;
+}
+
+void Filter_Reset(Filter_Chain *chain)
+{
+    uint8 i;
+    for (i = 0; i < chain->stages; i++)
+    {
+        chain->stage[i].count = 0;
+        chain->stage[i].pos = 0;
+        chain->stage[i].acc = 0;
+    }
+    chain->phase = 0;
+}
+
+uint8 Filter_Process(Filter_Chain *chain, int32 in, int32 *out)
+{
+    uint8 i;
+    for (i = 0; i < chain->stages; i++)
+    {
+        Filter_Stage *s = &chain->stage[i];
+        switch (s->type)
+        {
+            case FILTER_IIR:
+                in = Filter_Iir(s, in);
+                break;
+            case FILTER_MEDIAN:
+                in = Filter_Median(s, in);
+                break;
+            case FILTER_BOXCAR:
+                in = Filter_Boxcar(s, in);
+                break;
+            default:
+                break;
+        }
+    }
+    *out = in;
+
+    if (++chain->phase < chain->decimation)
+    {
+        return 0;
+    }
+    chain->phase = 0;
+    return 1;
+}
@@ -0,0 +1,49 @@
+#ifndef FILTER_H
+#define FILTER_H
+
+#include "project.h"
+#include "config.h"
+
+#define FILTER_NONE         0u
+#define FILTER_IIR          1u  // param: k, y += (x - y) / 2^k
+#define FILTER_MEDIAN       2u  // param: Fensterlaenge N
+#define FILTER_BOXCAR       3u  // param: Fensterlaenge N
+
+#define FILTER_IIR_MAX_K    8u
+#define FILTER_IIR_FRAC     8u  // Nachkommabits im IIR Zustand
+
+// Laufzeit pro Wert: IIR und Boxcar O(1). Der Median haelt sein Fenster
+// sortiert und schiebt pro Wert hoechstens 2 * N Eintraege, ist also O(N)
+// und nicht O(1). Mit N <= FILTER_WINDOW_MAX (Pruefung in Filter_AddStage()
+// und im Kommando FILTER) sind das im schlimmsten Fall 2 * 16 Schritte.
+// Wird FILTER_WINDOW_MAX groesser, waechst die Zeit pro Messwert mit, ueber
+// 32 bricht die Uebersetzung ab.
+typedef char Filter_CheckWindow[((FILTER_WINDOW_MAX > 0u) && (FILTER_WINDOW_MAX <= 32u)) ? 1 : -1];
+
+typedef struct
+{
+    uint8 type;
+    uint8 param;
+    uint8 count;                        // bisher gefuellte Fensterplaetze
+    uint8 pos;                          // aeltester Wert im Fenster
+    int32 acc;                          // IIR Zustand bzw. Boxcar Summe
+    int32 window[FILTER_WINDOW_MAX];    // Werte in Eingangsreihenfolge
+    int32 sorted[FILTER_WINDOW_MAX];    // gleiche Werte sortiert, nur Median
+} Filter_Stage;
+
+typedef struct
+{
+    Filter_Stage stage[FILTER_MAX_STAGES];
+    uint8 stages;
+    uint8 decimation;                   // nur jeder n-te Wert wird ausgegeben
+    uint8 phase;
+} Filter_Chain;
+
+void Filter_Init(Filter_Chain *chain, uint8 decimation);
+uint8 Filter_AddStage(Filter_Chain *chain, uint8 type, uint8 param);
+void Filter_Reset(Filter_Chain *chain);
+
+// Gibt 1 zurueck, wenn nach der Dezimierung ein Ausgangswert in *out steht
+uint8 Filter_Process(Filter_Chain *chain, int32 in, int32 *out);
+
+#endif /* FILTER_H */
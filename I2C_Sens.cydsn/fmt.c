@@ -0,0 +1,174 @@
+#include "fmt.h"
+#include <stdarg.h>
+
+uint8 Fmt_U64(char *out, uint64 value)
+{
+    char digits[20];
+    uint8 n = 0;
+    uint8 len = 0;
+
+    // in 9-stelligen Bloecken, damit nur eine 64 Bit Division pro Block noetig ist
+    do
+    {
+        uint32 block = (uint32)(value % 1000000000u);
+        uint8 i;
+        value /= 1000000000u;
+        for (i = 0; i < 9u; i++)
+        {
+            digits[n++] = (char)('0' + (block % 10u));
+            block /= 10u;
+            if ((value == 0) && (block == 0))
+            {
+                break;
+            }
+        }
+    } while (value != 0);
+
+    while (n > 0)
+    {
+        out[len++] = digits[--n];
+    }
+    out[len] = '\0';
+    return len;
+}
+
+uint8 Fmt_ParseU64(const char **text, uint64 *value)
+{
+    const char *s = *text;
+    uint64 v = 0;
+
+    while (*s == ' ')
+    {
+        s++;
+    }
+    if ((*s < '0') || (*s > '9'))
+    {
+        return 0;
+    }
+    while ((*s >= '0') && (*s <= '9'))
+    {
+        v = (v * 10u) + (uint64)(*s - '0');
+        s++;
+    }
+    *value = v;
+    *text = s;
+    return 1;
+}
+
+#if CONFIG_HEAP_FREE
+uint16 Fmt_Print(char *out, const char *format, ...)
+{
+    va_list args;
+    uint16 len = 0;
+
+    va_start(args, format);
+    while (*format)
+    {
+        char digits[11];
+        const char *text = digits;
+        uint8 n = 0;
+        uint8 width = 0;
+        char pad = ' ';
+        char sign = 0;
+        uint32 value;
+        uint32 base = 10;
+
+        if (*format != '%')
+        {
+            out[len++] = *format++;
+            continue;
+        }
+        format++;
+        if (*format == '0')
+        {
+            pad = '0';
+            format++;
+        }
+        while ((*format >= '0') && (*format <= '9'))
+        {
+            width = (uint8)(width * 10u + (uint8)(*format++ - '0'));
+        }
+        if (*format == 'l')
+        {
+            format++;       // long ist auf dem M3 auch 32 Bit
+        }
+
+        switch (*format)
+        {
+        case 's':
+            text = va_arg(args, const char *);
+            while (text[n])
+            {
+                n++;
+            }
+            break;
+        case 'c':
+            digits[n++] = (char)va_arg(args, int);
+            break;
+        case 'd':
+        case 'u':
+        case 'x':
+            value = va_arg(args, uint32);
+            if ((*format == 'd') && ((int32)value < 0))
+            {
+                sign = '-';
+                value = 0u - value;
+            }
+            if (*format == 'x')
+            {
+                base = 16;
+            }
+            do
+            {
+                digits[n++] = "0123456789abcdef"[value % base];
+                value /= base;
+            } while (value != 0);
+            break;
+        case '%':
+            digits[n++] = '%';
+            break;
+        default:
+            format--;       // unbekannt, Zeichen unveraendert ausgeben
+            break;
+        }
+        format++;
+
+        if (sign)
+        {
+            if (pad == '0')
+            {
+                out[len++] = sign;
+            }
+            width = (width > 0) ? width - 1u : 0;
+        }
+        while (width > n)
+        {
+            out[len++] = pad;
+            width--;
+        }
+        if (sign && (pad != '0'))
+        {
+            out[len++] = sign;
+        }
+        if (text == digits)
+        {
+            // Ziffern stehen rueckwaerts im Puffer
+            while (n > 0)
+            {
+                out[len++] = digits[--n];
+            }
+        }
+        else
+        {
+            uint8 i;
+            for (i = 0; i < n; i++)
+            {
+                out[len++] = text[i];
+            }
+        }
+    }
+    va_end(args);
+    out[len] = '\0';
+    return len;
+}
+#endif
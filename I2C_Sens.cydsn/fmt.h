@@ -0,0 +1,25 @@
+#ifndef FMT_H
+#define FMT_H
+
+#include "project.h"
+#include "config.h"
+
+// Zahlen <-> Text fuer Werte, die newlib nano printf nicht kann (64 Bit)
+
+// schreibt value dezimal nach out (mind. 21 Bytes), gibt die Laenge zurueck
+uint8 Fmt_U64(char *out, uint64 value);
+
+// liest eine Dezimalzahl ab *text, fuehrende Leerzeichen werden uebersprungen.
+// *text zeigt danach hinter die Zahl. Gibt 0 zurueck, wenn keine Ziffer da war.
+uint8 Fmt_ParseU64(const char **text, uint64 *value);
+
+// sprintf() Ersatz ohne newlib. Kann %s, %c, %d, %u, %x jeweils auch mit l
+// und mit Breite bzw. fuehrenden Nullen (%02lu). Gibt die Laenge zurueck.
+#if CONFIG_HEAP_FREE
+uint16 Fmt_Print(char *out, const char *format, ...);
+#else
+#include <stdio.h>
+#define Fmt_Print sprintf
+#endif
+
+#endif /* FMT_H */
@@ -0,0 +1,210 @@
+#ifndef HAL_H
+#define HAL_H
+
+#include "project.h"
+
+// Alle Zugriffe der Treiber auf Komponenten laufen ueber diese Datei: Bus
+// (I2C Master), Warten, Ausgabe (UART) und den EOC Pin. Die Bindung steht
+// zur Uebersetzungszeit fest, jede Funktion ist static inline und wird zum
+// direkten Aufruf der Komponenten API, ohne Funktionszeiger oder Umweg.
+// Zeit und Takte kommen weiterhin aus perf.h und timebase.h.
+//
+// HAL_SIM 1: der I2C Master spricht mit einem nachgebildeten BMP180 in
+// hal_sim.c (Kalibrierung und Rohwerte aus dem Datenblattbeispiel,
+// Wandlungszeiten wie beim echten Sensor). Damit laufen bus.c, bmp180.c und
+// acq.c unveraendert ohne Sensor, z.B. zum Vergleichen von Treiberaenderungen.
+// Dazu kommen BUS_MAX_MUX TCA9548A ab BUS_MUX_ADDR mit einem eigenen BMP180
+// hinter jedem Kanal. Es antwortet der Sensor auf dem einzigen offenen Pfad; sind
+// mehrere offen (auch der direkte, wenn Hal_simDirect gesetzt ist), zaehlt
+// Hal_simConflicts und keiner antwortet.
+//
+// Auf dem PC: test/host/project.h ersetzt das generierte project.h (Typen,
+// Konstanten, simulierte Zeit, UART in einen Puffer) und test/Makefile baut
+// dieselben Treiberquellen mit HAL_SIM 1 fuer Tests und Benchmarks.
+#ifndef HAL_SIM
+#define HAL_SIM             0
+#endif
+
+// --- Bus -----------------------------------------------------------------
+#if HAL_SIM
+void Hal_SimStart(void);
+uint8 Hal_SimWrite(uint8 addr, uint8 *data, uint8 len, uint8 mode);
+uint8 Hal_SimRead(uint8 addr, uint8 *data, uint8 len, uint8 mode);
+uint8 Hal_SimStatus(void);
+void Hal_SimClearStatus(void);
+void Hal_SimStop(void);
+
+#define HAL_SIM_DIRECT      (BUS_MAX_MUX * BUS_MUX_CHANNELS)   // Pfad ohne Mux
+extern uint8 Hal_simDirect;         // 1: ein BMP180 direkt am Bus (Vorgabe)
+extern uint8 Hal_simMux[];          // Steuerbyte je Mux
+extern uint32 Hal_simMuxWrites;
+extern uint32 Hal_simConflicts;
+extern uint32 Hal_simAccesses[];    // Sensorzugriffe je Pfad mux * 8 + Kanal, HAL_SIM_DIRECT
+extern uint32 Hal_simEarlyReads;    // Ergebnis gelesen, bevor die Wandlung fertig war
+#endif
+
+static inline void Hal_I2CStart(void)
+{
+#if HAL_SIM
+    Hal_SimStart();
+#else
+    I2C_Start();
+#endif
+}
+
+static inline uint8 Hal_I2CWrite(uint8 addr, uint8 *data, uint8 len, uint8 mode)
+{
+#if HAL_SIM
+    return Hal_SimWrite(addr, data, len, mode);
+#else
+    return I2C_MasterWriteBuf(addr, data, len, mode);
+#endif
+}
+
+static inline uint8 Hal_I2CRead(uint8 addr, uint8 *data, uint8 len, uint8 mode)
+{
+#if HAL_SIM
+    return Hal_SimRead(addr, data, len, mode);
+#else
+    return I2C_MasterReadBuf(addr, data, len, mode);
+#endif
+}
+
+static inline uint8 Hal_I2CStatus(void)
+{
+#if HAL_SIM
+    return Hal_SimStatus();
+#else
+    return I2C_MasterStatus();
+#endif
+}
+
+static inline void Hal_I2CClearStatus(void)
+{
+#if HAL_SIM
+    Hal_SimClearStatus();
+#else
+    (void)I2C_MasterClearStatus();
+#endif
+}
+
+static inline void Hal_I2CStop(void)
+{
+#if HAL_SIM
+    Hal_SimStop();
+#else
+    (void)I2C_MasterSendStop();
+#endif
+}
+
+// SCL = Bustakt / (16 * divider), nur bei freiem Bus aendern
+static inline void Hal_I2CSetDivider(uint16 divider)
+{
+#if HAL_SIM
+    (void)divider;
+#else
+    I2C_CLKDIV1_REG = LO8(divider);
+    I2C_CLKDIV2_REG = HI8(divider);
+#endif
+}
+
+// --- Warten --------------------------------------------------------------
+static inline void Hal_DelayMs(uint32 ms)
+{
+    CyDelay(ms);
+}
+
+static inline void Hal_DelayUs(uint16 us)
+{
+    CyDelayUs(us);
+}
+
+// --- Ausgabe -------------------------------------------------------------
+static inline void Hal_UartStart(void)
+{
+    UART_Start();
+}
+
+static inline uint8 Hal_UartTxReady(void)
+{
+    return (UART_ReadTxStatus() & UART_TX_STS_FIFO_NOT_FULL) != 0;
+}
+
+// nur der FIFO: das letzte Byte kann noch im Schieberegister sein (Out_Idle())
+static inline uint8 Hal_UartTxIdle(void)
+{
+    return (UART_ReadTxStatus() & UART_TX_STS_FIFO_EMPTY) != 0;
+}
+
+static inline void Hal_UartTxPut(uint8 c)
+{
+    UART_WriteTxData(c);
+}
+
+// Status einmal lesen, dann HAL_RX_READY/HAL_RX_OVERRUN pruefen
+#define HAL_RX_READY        UART_RX_STS_FIFO_NOTEMPTY
+#define HAL_RX_OVERRUN      UART_RX_STS_OVERRUN
+
+static inline uint8 Hal_UartRxStatus(void)
+{
+    return UART_ReadRxStatus();
+}
+
+static inline uint8 Hal_UartRxGet(void)
+{
+    return UART_ReadRxData();
+}
+
+static inline void Hal_UartRxClear(void)
+{
+    UART_ClearRxBuffer();
+}
+
+// neuer Teiler fuer den Baudratentakt, die UART steht dabei kurz
+static inline void Hal_UartSetDivider(uint16 divider)
+{
+    UART_Stop();
+    UART_IntClock_SetDividerRegister((uint16)(divider - 1u), 1u);
+    UART_Enable();
+    UART_ClearRxBuffer();
+}
+
+// nur der Teiler, fuer einen neuen Quelltakt bei gleicher Baudrate. Ein
+// Zeichen, das gerade gesendet oder empfangen wird, geht dabei kaputt.
+static inline void Hal_UartRetune(uint16 divider)
+{
+    UART_IntClock_SetDividerRegister((uint16)(divider - 1u), 1u);
+}
+
+// --- Schlafen -----------------------------------------------------------
+// Bus und UART vor CyPmSleep() sichern und danach wieder starten
+static inline void Hal_Sleep(void)
+{
+#if !HAL_SIM
+    I2C_Sleep();
+#endif
+    UART_Sleep();
+}
+
+static inline void Hal_Wakeup(void)
+{
+#if !HAL_SIM
+    I2C_Wakeup();
+#endif
+    UART_Wakeup();
+}
+
+// --- EOC Pin -------------------------------------------------------------
+// nur wenn im TopDesign eine Pin Komponente "EOC" liegt
+#if defined(CY_PINS_EOC_H) && !HAL_SIM
+#define HAL_HAS_EOC         1
+
+static inline uint8 Hal_EocRead(void)
+{
+    return EOC_Read();
+}
+#else
+#define HAL_HAS_EOC         0
+#endif
+
+#endif /* HAL_H */
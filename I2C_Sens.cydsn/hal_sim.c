@@ -0,0 +1,251 @@
+#include "hal.h"
+
+#if HAL_SIM
+#include "bmp180.h"
+#include "bus.h"
+#include "perf.h"
+
+#define SIM_REG_CALIB   0xAAu
+#define SIM_REG_ID      0xD0u
+#define SIM_CHIP_ID     0x55u
+#define SIM_UT          27898       // Datenblattbeispiel: 15.0 C
+#define SIM_UP          23843       // 69964 Pa bei OSS 0
+#define SIM_BYTE_US     90u         // 9 Bit bei 100 kHz (I2C_DATA_RATE)
+
+// AC1..MD aus dem Datenblattbeispiel, big endian wie im Sensor
+static const uint8 simCalib[22] =
+{
+    0x01, 0x98, 0xFF, 0xB8, 0xC7, 0xD1, 0x7F, 0xE5, 0x7F, 0xF5, 0x5A, 0x71,
+    0x18, 0x2E, 0x00, 0x04, 0x80, 0x00, 0xDD, 0xF9, 0x0B, 0x34
+};
+
+// Wandlungszeit in us: Temperatur, dann Druck je OSS
+static const uint16 simConvUs[5] = { 4500u, 4500u, 7500u, 13500u, 25500u };
+
+// Zustand je Sensor, ein Sensor je Pfad
+typedef struct
+{
+    uint8 reg;                  // Registerzeiger
+    uint8 ctrl;
+    uint8 result[3];
+    uint32 done;                // Perf_Cycles() am Ende der Wandlung
+} SimSensor;
+
+static uint8 simStatus;
+static SimSensor simSensor[HAL_SIM_DIRECT + 1u];
+static uint32 simNoise = 1u;
+
+uint8 Hal_simDirect = 1u;
+uint8 Hal_simMux[BUS_MAX_MUX];
+uint32 Hal_simMuxWrites;
+uint32 Hal_simConflicts;
+uint32 Hal_simAccesses[HAL_SIM_DIRECT + 1u];
+uint32 Hal_simEarlyReads;
+
+
+// so lange wie der echte Transfer: Adressbyte plus Daten
+static void Hal_SimBusTime(uint8 len)
+{
+    Hal_DelayUs((uint16)((len + 1u) * SIM_BYTE_US));
+}
+
+// +-2 LSB Rauschen, damit Filter etwas zu tun haben
+static int32 Hal_SimNoise(void)
+{
+    simNoise = simNoise * 1103515245u + 12345u;
+    return (int32)((simNoise >> 16) % 5u) - 2;
+}
+
+static void Hal_SimConvert(SimSensor *sensor, uint8 ctrl)
+{
+    uint8 oss = ctrl >> BMP180_OSS_SHIFT;
+    uint32 raw;
+
+    if ((ctrl & 0x3Fu) == BMP180_CMD_TEMP)
+    {
+        raw = (uint32)(SIM_UT + Hal_SimNoise()) << 8;
+        sensor->done = Perf_Cycles() + Perf_UsToCycles(simConvUs[0]);
+    }
+    else
+    {
+        // gleicher Druck bei jedem OSS, nur mehr Aufloesung
+        raw = (uint32)(((int32)SIM_UP << oss) + Hal_SimNoise()) << (8u - oss);
+        sensor->done = Perf_Cycles() + Perf_UsToCycles(simConvUs[1u + oss]);
+    }
+    sensor->result[0] = (uint8)(raw >> 16);
+    sensor->result[1] = (uint8)(raw >> 8);
+    sensor->result[2] = (uint8)raw;
+    sensor->ctrl = ctrl | BMP180_CTRL_SCO;
+}
+
+static uint8 Hal_SimRegister(SimSensor *sensor, uint8 reg)
+{
+    uint8 busy = (int32)(Perf_Cycles() - sensor->done) < 0;
+
+    if ((reg >= SIM_REG_CALIB) && (reg < SIM_REG_CALIB + sizeof(simCalib)))
+    {
+        return simCalib[reg - SIM_REG_CALIB];
+    }
+    if (reg == SIM_REG_ID)
+    {
+        return SIM_CHIP_ID;
+    }
+    if (reg == BMP180_REG_CTRL)
+    {
+        if (!busy)
+        {
+            sensor->ctrl &= (uint8)~BMP180_CTRL_SCO;
+        }
+        return sensor->ctrl;
+    }
+    if ((reg >= BMP180_REG_RESULT) && (reg < BMP180_REG_RESULT + 3u))
+    {
+        // Ergebnis vor Ende der Wandlung: beim echten Sensor noch das alte
+        if (busy && (reg == BMP180_REG_RESULT))
+        {
+            Hal_simEarlyReads++;
+        }
+        return sensor->result[reg - BMP180_REG_RESULT];
+    }
+    return 0;
+}
+
+// Pfad zum antwortenden Sensor, 0xFF wenn keiner oder mehrere erreichbar sind
+static uint8 Hal_SimPath(void)
+{
+    uint8 path = HAL_SIM_DIRECT;
+    uint8 open = Hal_simDirect ? 1u : 0u;
+    uint8 mux;
+    uint8 ch;
+
+    for (mux = 0; mux < BUS_MAX_MUX; mux++)
+    {
+        for (ch = 0; ch < BUS_MUX_CHANNELS; ch++)
+        {
+            if (Hal_simMux[mux] & (1u << ch))
+            {
+                path = (uint8)((mux * BUS_MUX_CHANNELS) + ch);
+                open++;
+            }
+        }
+    }
+    if (open != 1u)
+    {
+        if (open > 1u)
+        {
+            Hal_simConflicts++;
+        }
+        return 0xFFu;
+    }
+    Hal_simAccesses[path]++;
+    return path;
+}
+
+static uint8 Hal_SimIsMux(uint8 addr)
+{
+    return (addr >= BUS_MUX_ADDR) && (addr < BUS_MUX_ADDR + BUS_MAX_MUX);
+}
+
+void Hal_SimStart(void)
+{
+    uint8 i;
+
+    for (i = 0; i < BUS_MAX_MUX; i++)
+    {
+        Hal_simMux[i] = 0;
+    }
+    simStatus = 0;
+    for (i = 0; i <= HAL_SIM_DIRECT; i++)
+    {
+        simSensor[i].reg = 0;
+        simSensor[i].ctrl = 0;
+        simSensor[i].done = Perf_Cycles();
+    }
+}
+
+uint8 Hal_SimWrite(uint8 addr, uint8 *data, uint8 len, uint8 mode)
+{
+    SimSensor *sensor;
+    uint8 path;
+    uint8 i;
+
+    Hal_SimBusTime(len);
+    if (Hal_SimIsMux(addr))
+    {
+        // TCA9548A: das zuletzt geschriebene Byte ist das Steuerbyte
+        if (len > 0)
+        {
+            Hal_simMux[addr - BUS_MUX_ADDR] = data[len - 1u];
+            Hal_simMuxWrites++;
+        }
+        simStatus = I2C_MSTAT_WR_CMPLT;
+        return I2C_MSTR_NO_ERROR;
+    }
+    if ((addr != BMP180_ADDR) || ((path = Hal_SimPath()) == 0xFFu))
+    {
+        simStatus = I2C_MSTAT_ERR_ADDR_NAK | I2C_MSTAT_ERR_XFER;
+        return I2C_MSTR_NO_ERROR;
+    }
+    sensor = &simSensor[path];
+    // erstes Byte setzt den Registerzeiger, weitere Bytes werden geschrieben
+    for (i = 0; i < len; i++)
+    {
+        if (i == 0)
+        {
+            sensor->reg = data[0];
+        }
+        else if (sensor->reg == BMP180_REG_CTRL)
+        {
+            Hal_SimConvert(sensor, data[i]);
+        }
+    }
+    simStatus = I2C_MSTAT_WR_CMPLT | ((mode & I2C_MODE_NO_STOP) ? I2C_MSTAT_XFER_HALT : 0u);
+    return I2C_MSTR_NO_ERROR;
+}
+
+uint8 Hal_SimRead(uint8 addr, uint8 *data, uint8 len, uint8 mode)
+{
+    SimSensor *sensor;
+    uint8 path;
+    uint8 i;
+
+    (void)mode;
+    Hal_SimBusTime(len);
+    if (Hal_SimIsMux(addr))
+    {
+        for (i = 0; i < len; i++)
+        {
+            data[i] = Hal_simMux[addr - BUS_MUX_ADDR];
+        }
+        simStatus = I2C_MSTAT_RD_CMPLT;
+        return I2C_MSTR_NO_ERROR;
+    }
+    if ((addr != BMP180_ADDR) || ((path = Hal_SimPath()) == 0xFFu))
+    {
+        simStatus = I2C_MSTAT_ERR_ADDR_NAK | I2C_MSTAT_ERR_XFER;
+        return I2C_MSTR_NO_ERROR;
+    }
+    sensor = &simSensor[path];
+    for (i = 0; i < len; i++)
+    {
+        data[i] = Hal_SimRegister(sensor, sensor->reg++);
+    }
+    simStatus = I2C_MSTAT_RD_CMPLT;
+    return I2C_MSTR_NO_ERROR;
+}
+
+uint8 Hal_SimStatus(void)
+{
+    return simStatus;
+}
+
+void Hal_SimClearStatus(void)
+{
+    simStatus &= I2C_MSTAT_XFER_HALT;
+}
+
+void Hal_SimStop(void)
+{
+    simStatus = 0;
+}
+#endif
@@ -0,0 +1,148 @@
+#include "hib.h"
+#include "timebase.h"
+#include "perf.h"
+#include "out.h"
+#include "hal.h"
+#include "fmt.h"
+
+#define HIB_CAL_START   0u
+#define HIB_CAL_FIRST   1u
+#define HIB_CAL_SECOND  2u
+#define HIB_CAL_DONE    3u
+
+Hib_Stats Hib_stats;
+
+static uint8 hibCal;
+static uint64 hibCalStart;
+static uint64 hibAwakeSince;    // Ende der letzten Messung bzw. des letzten Schlafs
+static uint64 hibWake;          // 0: seit der letzten Messung nicht geschlafen
+
+
+void Hib_Init(void)
+{
+    Hib_stats.sleeps = 0;
+    Hib_stats.intervals = 0;
+    Hib_stats.ctwUs = 0;
+    Hib_stats.restoreUs = 0;
+    Hib_stats.latencyUs = 0;
+    Hib_stats.latencyMaxUs = 0;
+    hibCal = HIB_CAL_START;
+    hibAwakeSince = Time_Us();
+    hibWake = 0;
+}
+
+// CTW Intervall im Wachzustand ausmessen, ohne zu blockieren
+static uint8 Hib_Calibrate(uint64 now)
+{
+    switch (hibCal)
+    {
+    case HIB_CAL_START:
+        CyPmCtwSetInterval(HIB_CTW_INTERVAL);
+        (void)CyPmReadStatus(CY_PM_CTW_INT);
+        hibCal = HIB_CAL_FIRST;
+        break;
+    case HIB_CAL_FIRST:
+        // das erste Intervall kann kuerzer sein, erst ab dem naechsten Ereignis zaehlen
+        if (CyPmReadStatus(CY_PM_CTW_INT) & CY_PM_CTW_INT)
+        {
+            hibCalStart = now;
+            hibCal = HIB_CAL_SECOND;
+        }
+        break;
+    case HIB_CAL_SECOND:
+        if (CyPmReadStatus(CY_PM_CTW_INT) & CY_PM_CTW_INT)
+        {
+            Hib_stats.ctwUs = (uint32)(now - hibCalStart);
+            hibCal = HIB_CAL_DONE;
+        }
+        break;
+    default:
+        break;
+    }
+    return hibCal == HIB_CAL_DONE;
+}
+
+static void Hib_Sleep(uint32 intervals)
+{
+    uint32 i;
+    uint32 start;
+
+    Hal_Sleep();
+    // CTW neu starten: bei gleichem Intervall laesst CyPmCtwSetInterval() ihn
+    // weiterlaufen, das erste Wecken kaeme nach einem beliebigen Teilintervall
+    // und Time_Advance() wuerde trotzdem ein volles nachtragen
+    CY_PM_TW_CFG2_REG &= (uint8)~CY_PM_CTW_EN;
+    CyPmCtwSetInterval(HIB_CTW_INTERVAL);
+    // CyPmCtwSetInterval() schaltet das Weckereignis ab
+    CY_PM_TW_CFG2_REG |= CY_PM_CTW_IE;
+    (void)CyPmReadStatus(CY_PM_CTW_INT);
+
+    CyPmSaveClocks();
+    for (i = 0; i < intervals; i++)
+    {
+        CyPmSleep(PM_SLEEP_TIME_NONE, PM_SLEEP_SRC_CTW);
+        (void)CyPmReadStatus(CY_PM_CTW_INT);
+    }
+    start = Perf_Cycles();
+    CyPmRestoreClocks();
+    Hib_stats.restoreUs = (Perf_Cycles() - start) / (HIB_SAVED_CLOCK_HZ / 1000000u);
+
+    CY_PM_TW_CFG2_REG &= (uint8)~CY_PM_CTW_IE;
+    Hal_Wakeup();
+
+    // SysTick stand still, die Zeit nachtragen
+    Time_Advance((uint64)intervals * Hib_stats.ctwUs + Hib_stats.restoreUs);
+    hibWake = Time_Us() - Hib_stats.restoreUs;
+    hibAwakeSince = hibWake;
+    Hib_stats.sleeps++;
+    Hib_stats.intervals += intervals;
+}
+
+void Hib_Idle(uint64 deadline)
+{
+    uint64 now = Time_Us();
+    uint64 lead = (uint64)HIB_WAKE_LEAD_MS * 1000u;
+    uint32 intervals;
+
+    if (!Hib_Calibrate(now) || (now - hibAwakeSince < (uint64)HIB_LISTEN_MS * 1000u) || (deadline < now + lead))
+    {
+        return;
+    }
+    intervals = (uint32)((deadline - now - lead) / Hib_stats.ctwUs);
+    // UART_Sleep() erst, wenn auch das letzte Byte draussen ist
+    if ((intervals == 0) || !Out_Idle())
+    {
+        return;
+    }
+    Hib_Sleep(intervals);
+}
+
+void Hib_SampleDone(const Acq_Sample *sample)
+{
+    if (hibWake != 0)
+    {
+        Hib_stats.latencyUs = (uint32)(sample->tEnd - hibWake);
+        if (Hib_stats.latencyUs > Hib_stats.latencyMaxUs)
+        {
+            Hib_stats.latencyMaxUs = Hib_stats.latencyUs;
+        }
+        hibWake = 0;
+    }
+    hibAwakeSince = sample->tEnd;
+}
+
+void Hib_Report(void)
+{
+    char buffer[80];
+
+    if (Hib_stats.sleeps == 0)
+    {
+        return;
+    }
+    Fmt_Print(buffer, "Stats: sleep %lu x, %lu ctw of %lu us, restore %lu us\r\n",
+              Hib_stats.sleeps, Hib_stats.intervals, Hib_stats.ctwUs, Hib_stats.restoreUs);
+    Out_Print(buffer);
+    Fmt_Print(buffer, "Stats: wake to sample %lu us, max %lu us\r\n",
+              Hib_stats.latencyUs, Hib_stats.latencyMaxUs);
+    Out_Print(buffer);
+}
@@ -0,0 +1,54 @@
+#ifndef HIB_H
+#define HIB_H
+
+#include "project.h"
+#include "acq.h"
+
+// Lange Messabstaende (PERIOD ab HIB_MIN_PERIOD_US): zwischen den Terminen
+// schlaeft der Chip im Sleep Modus, statt in Acq_Idle() zu kreisen. SRAM und
+// Register bleiben dabei erhalten und das Programm laeuft nach dem Aufwachen
+// einfach weiter, Kalibrierung, Sequenznummern und Filterzustand sind also
+// ohne Neulesen sofort da und die Messung startet direkt zum Termin.
+//
+// Geweckt wird ueber den Central Timewheel (1 kHz ILO). Der ILO ist sehr
+// ungenau, deshalb wird ein CTW Intervall einmal im Wachzustand gegen den
+// SysTick ausgemessen und die verschlafene Zeit damit in timebase.h
+// nachgetragen. Aufgewacht wird HIB_WAKE_LEAD_MS vor dem Termin, den Rest
+// wartet Acq_WaitDeadline() wie bisher.
+//
+// CyPmHibernate() braucht beim PSoC 5LP einen Pin (PICU) zum Aufwachen, den
+// das TopDesign nicht hat; mit einem externen Wecker an einem Pin "Wake"
+// (z.B. RTC Alarm) waere es der gleiche Ablauf.
+//
+// Nach einer Messung bleibt der Chip HIB_LISTEN_MS wach, damit Kommandos
+// ankommen, und geschlafen wird nur, wenn nichts mehr zu senden ist.
+#define HIB_ENABLE          1
+#define HIB_MIN_PERIOD_US   60000000u
+#define HIB_LISTEN_MS       500u
+#define HIB_WAKE_LEAD_MS    20u
+#define HIB_CTW_INTERVAL    0x0Au       // CyPmCtwSetInterval(): 2^n ILO Takte = 1024 ms
+#define HIB_SAVED_CLOCK_HZ  12000000u   // Takt zwischen CyPmSaveClocks() und CyPmRestoreClocks()
+
+typedef struct
+{
+    uint32 sleeps;
+    uint32 intervals;           // verschlafene CTW Intervalle
+    uint32 ctwUs;               // gemessene Laenge eines Intervalls, 0 = noch nicht
+    uint32 restoreUs;           // Takte wieder hochfahren, letzter Wert
+    uint32 latencyUs;           // Aufwachen bis Messung fertig, letzter Wert
+    uint32 latencyMaxUs;
+} Hib_Stats;
+
+extern Hib_Stats Hib_stats;
+
+void Hib_Init(void);
+
+// aus der Wartezeit vor einem Termin, schlaeft wenn es sich lohnt
+void Hib_Idle(uint64 deadline);
+
+// nach jeder Messung, fuer die Aufwach Latenz und das Wachfenster
+void Hib_SampleDone(const Acq_Sample *sample);
+
+void Hib_Report(void);
+
+#endif /* HIB_H */
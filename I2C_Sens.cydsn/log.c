@@ -0,0 +1,113 @@
+#include "log.h"
+#include "out.h"
+
+Codec_Encoder Log_encoder;
+uint32 Log_dropped;
+
+static uint8 logBuffer[LOG_SIZE];
+static uint16 logUsed;
+static uint16 dumpPos;
+static uint16 dumpEnd;
+static uint8 dumping;
+
+
+void Log_Init(void)
+{
+    Codec_InitEncoder(&Log_encoder, LOG_CHANNELS, LOG_KEY_INTERVAL, 0);
+    Log_dropped = 0;
+    logUsed = 0;
+    dumping = 0;
+}
+
+void Log_Clear(void)
+{
+    logUsed = 0;
+    dumping = 0;
+    Codec_ForceKeyframe(&Log_encoder);
+}
+
+uint16 Log_Used(void)
+{
+    return logUsed;
+}
+
+// offenen Block abschliessen. Log_Add() laesst dafuer immer CODEC_TRAILER frei.
+static void Log_Close(void)
+{
+    logUsed += Codec_Flush(&Log_encoder, &logBuffer[logUsed]);
+}
+
+uint8 Log_Add(const Acq_Sample *sample)
+{
+    int32_t values[LOG_CHANNELS] = { sample->ut, sample->up };
+
+    // Luecke in der Sequenz: Deltas passen nicht mehr, neuer Keyframe
+    if (sample->seq != Log_encoder.seq)
+    {
+        Log_Close();
+        Log_encoder.seq = sample->seq;
+    }
+
+    if (logUsed + CODEC_MAX_RECORD > LOG_SIZE)
+    {
+        Log_dropped++;
+        Log_Close();
+        Log_encoder.seq = sample->seq + 1u;
+        return 0;
+    }
+
+    logUsed += Codec_Encode(&Log_encoder, values, &logBuffer[logUsed]);
+    return 1;
+}
+
+void Log_Dump(void)
+{
+    Log_Close();
+    Out_Write(logBuffer, logUsed);
+    Log_Clear();
+}
+
+uint16 Log_StartDump(void)
+{
+    // gesendet werden nur abgeschlossene Bloecke, neue Eintraege beginnen einen neuen
+    Log_Close();
+    dumpPos = 0;
+    dumpEnd = logUsed;
+    dumping = 1;
+    return dumpEnd;
+}
+
+uint8 Log_Dumping(void)
+{
+    return dumping;
+}
+
+void Log_DumpPoll(void)
+{
+    uint16 n;
+    uint16 i;
+
+    if (!dumping)
+    {
+        return;
+    }
+
+    n = Out_Free();
+    if (n > dumpEnd - dumpPos)
+    {
+        n = dumpEnd - dumpPos;
+    }
+    Out_Write(&logBuffer[dumpPos], n);
+    dumpPos += n;
+
+    if (dumpPos == dumpEnd)
+    {
+        // waehrend des Sendens angehaengte Eintraege nach vorne holen
+        for (i = dumpEnd; i < logUsed; i++)
+        {
+            logBuffer[i - dumpEnd] = logBuffer[i];
+        }
+        logUsed -= dumpEnd;
+        dumping = 0;
+    }
+}
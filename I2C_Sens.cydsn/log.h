@@ -0,0 +1,32 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include "project.h"
+#include "acq.h"
+#include "codec.h"
+#include "config.h"
+
+// Rohwert Log (UT/UP), delta/varint kodiert. Kompensiert wird erst beim
+// Auslesen bzw. auf dem Host (BMP180_CompensateBatch()). Groesse LOG_SIZE in config.h.
+#define LOG_KEY_INTERVAL    32u
+#define LOG_CHANNELS        2u
+
+extern Codec_Encoder Log_encoder;
+extern uint32 Log_dropped;      // Messungen, die nicht mehr ins Log passten
+
+void Log_Init(void);
+void Log_Clear(void);
+uint8 Log_Add(const Acq_Sample *sample);
+uint16 Log_Used(void);
+
+// schickt den Logstrom ueber Out und leert das Log
+void Log_Dump(void);
+
+// dasselbe ohne zu blockieren: Log_StartDump() merkt sich den aktuellen
+// Inhalt, Log_DumpPoll() schiebt davon so viel nach, wie Out gerade frei hat.
+// Was waehrenddessen dazukommt, beginnt mit einem Keyframe und bleibt im Log.
+uint16 Log_StartDump(void);     // Anzahl Bytes, die gesendet werden
+void Log_DumpPoll(void);
+uint8 Log_Dumping(void);
+
+#endif /* LOG_H */
@@ -1,138 +1,579 @@
 #include "project.h"
-#include <stdio.h>
+#include "bmp180.h"
+#include "acq.h"
+#include "out.h"
+#include "perf.h"
+#include "filter.h"
+#include "altitude.h"
+#include "sampleq.h"
+#include "winstat.h"
+#include "codec.h"
+#include "log.h"
+#include "timebase.h"
+#include "rx.h"
+#include "tsync.h"
+#include "fmt.h"
+#include "settings.h"
+#include "cmd.h"
+#include "baud.h"
+#include "mem.h"
+#include "boot.h"
+#include "bus.h"
+#include "sched.h"
+#include "trace.h"
+#include "clock.h"
+#include "hib.h"
 
-#define BMP180_ADDR 0x77  // BMP180 I2C addresse
+#define ACQ_MODE        ACQ_MODE_PIPELINED
+#define ACQ_WAIT        ACQ_WAIT_EOC
+#define SAMPLE_PERIOD_US 0      // 0: freilaufend, sonst feste Termine (z.B. 2000000)
+#define SAMPLE_OSS      0       // Oversampling der Druckmessung
+#define OUTPUT_DECIMATION 8     // jeder 8. gefilterte Wert geht raus
+#define OUTPUT_FORMAT   OUTPUT_FORMAT_ASCII
+#define TELEMETRY_KEY_INTERVAL 16
+#define TELEMETRY_ORDER2 0x04u  // Zeit (Kanal 2) als zweite Differenz, siehe codec.h
+#define LOG_RAW         1       // jede Rohmessung ins Log
+#define OUTPUT_SAMPLES  1       // gefilterte Einzelwerte senden
+#define OUTPUT_SUMMARY  1       // Zusammenfassung pro Fenster senden
+#define SUMMARY_WINDOW  256     // Messungen pro Zusammenfassung
+#define BENCH_COMPENSATION 0    // Taktvergleich float/Fast Kompensation beim Start
+#define BENCH_ALTITUDE     0    // Takte pro Hoehenberechnung beim Start
+#define BENCH_SCHEDULER    0    // verschachtelt gegen nacheinander, mit nachgebildeten Sensoren
+#define BENCH_SCHED_DEVICES 4
+#define BENCH_SCHED_ROUNDS  8
+#define SENSOR_MUX_ADDR    0       // 0: Sensor direkt am Bus, sonst Adresse des I2C Mux
+#define SENSOR_MUX_CHANNEL 0
 
-// kalibrations variablen
-int16 AC1, AC2, AC3, B1, B2, MB, MC, MD;
-uint16 AC4, AC5, AC6;
+static Filter_Chain pressureFilter;
+static Filter_Chain tempFilter;
+static SampleQ sampleQueue;
+static WinStat pressureStat;
+static WinStat tempStat;
+static Codec_Encoder telemetry;
+static Settings settings;       // Vorgaben oben, ueberschrieben aus dem Em_EEPROM
+static uint32 badSamples;       // wegen Busfehlern verworfen
+static uint64 statsLast;        // Time_Us() der letzten Stats Ausgabe
 
 
+void UART_Print(const char *string)
+{
+    Out_Print(string);
+}
 
+// waehrend eines Log oder Trace Dumps geht nichts anderes raus
+static uint8 Dumping(void)
+{
+    return Log_Dumping() || Trace_Dumping();
+}
 
-void BMP180_WriteByte(uint8 reg, uint8 value)
+// offenen Telemetrieblock abschliessen, damit Text nur zwischen Bloecken steht
+static void CloseTelemetry(void)
 {
-    uint8 data[2] = { reg, value };
-    I2C_MasterWriteBuf(BMP180_ADDR, data, 2, I2C_MODE_COMPLETE_XFER);
-    while (I2C_MasterStatus() & I2C_MSTAT_XFER_INP);
+    uint8 trailer[CODEC_TRAILER];
+    Out_Write(trailer, Codec_Flush(&telemetry, trailer));
 }
 
-uint16 BMP180_ReadWord(uint8 reg)
+static void PrintConv(const char *name, const Acq_ConvStats *conv)
 {
-    uint8 data[2];
-    I2C_MasterWriteBuf(BMP180_ADDR, &reg, 1, I2C_MODE_COMPLETE_XFER);
-    while (I2C_MasterStatus() & I2C_MSTAT_XFER_INP);
+    char buffer[80];
+    if (conv->count == 0)
+    {
+        return;
+    }
+    Fmt_Print(buffer, "Stats: %s conv %lu/%lu/%lu us, polls %lu, timeouts %lu\r\n", name,
+            conv->minUs, conv->sumUs / conv->count, conv->maxUs, conv->polls, conv->timeouts);
+    UART_Print(buffer);
+}
 
-    I2C_MasterReadBuf(BMP180_ADDR, data, 2, I2C_MODE_COMPLETE_XFER);
-    while (I2C_MasterStatus() & I2C_MSTAT_XFER_INP);
+// Durchsatz je Mux Kanal, nur Kanaele mit Verkehr
+static void PrintChannels(void)
+{
+    char buffer[80];
+    uint8 mux;
+    uint8 ch;
 
-    return ((uint16)data[0] << 8) | data[1];
+    for (mux = 0; mux < Bus_MuxCount(); mux++)
+    {
+        for (ch = 0; ch < BUS_MUX_CHANNELS; ch++)
+        {
+            Bus_ChannelStats *stats = &Bus_channelStats[mux][ch];
+            if (stats->transactions == 0)
+            {
+                continue;
+            }
+            Fmt_Print(buffer, "Stats: mux %u ch %u: %lu xfers, %lu B/s, %lu selects\r\n", mux, ch,
+                      stats->transactions,
+                      (uint32)(((uint64)stats->bytes * PERF_CPU_HZ) / (stats->cycles ? stats->cycles : 1u)),
+                      stats->selects);
+            UART_Print(buffer);
+            stats->transactions = 0;
+            stats->bytes = 0;
+            stats->cycles = 0;
+            stats->selects = 0;
+        }
+    }
 }
 
+static void PrintStats(void)
+{
+    char buffer[80];
+    uint32 rate = Acq_SamplesPerSecondX100();
+    uint32 n = Acq_stats.samples - 1;
+    uint32 avg = (n > 0) ? (uint32)(Acq_stats.periodSum / n) : 0;
+    uint32 busy = (Acq_stats.periodSum > Acq_stats.waitSum)
+                ? (uint32)((Acq_stats.periodSum - Acq_stats.waitSum) / (n > 0 ? n : 1)) : 0;
+
+    Fmt_Print(buffer, "Stats: %lu.%02lu S/s, period %lu/%lu/%lu us, busy %lu us\r\n",
+            rate / 100, rate % 100,
+            Acq_stats.periodMin, avg, Acq_stats.periodMax, busy);
+    UART_Print(buffer);
+    Fmt_Print(buffer, "Stats: uart %lu baud, stalls %lu, queue max %lu drops %lu\r\n",
+            Baud_Get(), Out_stalls, sampleQueue.highWater, sampleQueue.drops);
+    UART_Print(buffer);
+    if (Acq_stats.jitterCount > 0)
+    {
+        Fmt_Print(buffer, "Stats: jitter avg %lu max %lu us, missed %lu\r\n",
+                Acq_stats.jitterSum / Acq_stats.jitterCount, Acq_stats.jitterMax, Acq_stats.missed);
+        UART_Print(buffer);
+    }
+    if (TimeSync_Valid())
+    {
+        Fmt_Print(buffer, "Stats: sync %lu/%lu, delay %lu us, drift %ld ppb\r\n",
+                TimeSync_stats.exchanges, TimeSync_stats.rejected,
+                TimeSync_stats.delayUs, TimeSync_stats.driftPpb);
+        UART_Print(buffer);
+    }
+    PrintConv("T", &Acq_tempConv);
+    PrintConv("P", &Acq_presConv);
+
+    uint32 tx = Codec_BytesPerRecordX100(&telemetry);
+    uint32 lg = Codec_BytesPerRecordX100(&Log_encoder);
+    Fmt_Print(buffer, "Stats: codec tx %lu.%02lu B, log %lu.%02lu B per record\r\n",
+            tx / 100, tx % 100, lg / 100, lg % 100);
+    UART_Print(buffer);
+    Fmt_Print(buffer, "Stats: log %u bytes, dropped %lu\r\n", Log_Used(), Log_dropped);
+    UART_Print(buffer);
+#if CLOCK_GOVERNOR
+    Clock_Report();
+#endif
+#if HIB_ENABLE
+    Hib_Report();
+#endif
+#if BUS_TRACE
+    Fmt_Print(buffer, "Stats: trace %u bytes, %lu records, overwritten %lu\r\n",
+              Trace_Used(), Trace_records, Trace_dropped);
+    UART_Print(buffer);
+#endif
+    if (Bus_stats.retries || Bus_stats.failures)
+    {
+        Fmt_Print(buffer, "Stats: i2c busy %lu, arb lost %lu, retries %lu, backoff %lu us\r\n",
+                  Bus_stats.busy, Bus_stats.arbLost, Bus_stats.retries, Bus_stats.backoffUs);
+        UART_Print(buffer);
+        Fmt_Print(buffer, "Stats: i2c failed %lu/%lu, samples dropped %lu\r\n",
+                  Bus_stats.failures, Bus_stats.transactions, badSamples);
+        UART_Print(buffer);
+    }
+    PrintChannels();
+}
 
-void BMP180_ReadCalibrationData(void)
+static void DefaultSettings(void)
 {
-    AC1 = (int16)BMP180_ReadWord(0xAA);
-    AC2 = (int16)BMP180_ReadWord(0xAC);
-    AC3 = (int16)BMP180_ReadWord(0xAE);
-    AC4 = BMP180_ReadWord(0xB0);
-    AC5 = BMP180_ReadWord(0xB2);
-    AC6 = BMP180_ReadWord(0xB4);
-    B1  = (int16)BMP180_ReadWord(0xB6);
-    B2  = (int16)BMP180_ReadWord(0xB8);
-    MB  = (int16)BMP180_ReadWord(0xBA);
-    MC  = (int16)BMP180_ReadWord(0xBC);
-    MD  = (int16)BMP180_ReadWord(0xBE);
+    uint8 i;
+
+    settings.oss = SAMPLE_OSS;
+    settings.periodUs = SAMPLE_PERIOD_US;
+    settings.mode = ACQ_MODE;
+    settings.format = OUTPUT_FORMAT;
+    settings.decimation = OUTPUT_DECIMATION;
+    for (i = 0; i < FILTER_MAX_STAGES; i++)
+    {
+        settings.pressure[i].type = FILTER_NONE;
+        settings.temp[i].type = FILTER_NONE;
+    }
+
+    // Druck: Ausreisser per Median weg, dann glaetten
+    settings.pressure[0].type = FILTER_MEDIAN;
+    settings.pressure[0].param = 5;
+    settings.pressure[1].type = FILTER_IIR;
+    settings.pressure[1].param = 2;
+
+    settings.temp[0].type = FILTER_BOXCAR;
+    settings.temp[0].param = 8;
 }
 
-int16 BMP180_ReadRawTemperature(void)
+static void SetupFilter(Filter_Chain *chain, const Settings_Stage *stage)
 {
-    BMP180_WriteByte(0xF4, 0x2E);
-    CyDelay(5); 
-    return BMP180_ReadWord(0xF6);
+    uint8 i;
+
+    Filter_Init(chain, settings.decimation);
+    for (i = 0; i < FILTER_MAX_STAGES; i++)
+    {
+        if (stage[i].type != FILTER_NONE)
+        {
+            Filter_AddStage(chain, stage[i].type, stage[i].param);
+        }
+    }
 }
 
-int32 BMP180_ReadRawPressure(void)
+static void SetupFilters(void)
 {
-    BMP180_WriteByte(0xF4, 0x34);
-    CyDelay(8);
-    return (int32)BMP180_ReadWord(0xF6);
+    SetupFilter(&pressureFilter, settings.pressure);
+    SetupFilter(&tempFilter, settings.temp);
 }
 
+static void PrintSummary(void)
+{
+    char buffer[80];
+    WinStat_Summary p;
+    WinStat_Summary t;
+
+    WinStat_Get(&pressureStat, &p);
+    WinStat_Get(&tempStat, &t);
+    Fmt_Print(buffer, "Summary: n=%lu P %ld/%ld/%ld sd %lu Pa\r\n", p.count, p.min, p.mean, p.max, p.stddev);
+    UART_Print(buffer);
+    Fmt_Print(buffer, "Summary: T %ld/%ld/%ld sd %lu x0.1 C\r\n", t.min, t.mean, t.max, t.stddev);
+    UART_Print(buffer);
+
+    WinStat_Reset(&pressureStat);
+    WinStat_Reset(&tempStat);
+}
 
-float BMP180_CalculateTemperature(int16 ut, int32 *B5)
+static void ProcessSample(const Acq_Sample *sample)
 {
-    int32 X1 = (((int32)ut - AC6) * AC5) >> 15;
-    int32 X2 = ((int32)MC << 11) / (X1 + MD);
-    *B5 = X1 + X2;
-    float T = (((*B5 + 8) >> 4)) / 10.0;  // Temperature in °C
-    return T;
+    if (sample->errors)
+    {
+        badSamples++;
+        return;
+    }
+
+    int32 B5 = BMP180_CalculateB5Fast(sample->ut);
+    int32 pressure = BMP180_CalculatePressure(sample->up, B5);
+    int32 temp = BMP180_TemperatureX10(B5);
+
+#if LOG_RAW
+    Log_Add(sample);
+#endif
+
+#if OUTPUT_SUMMARY
+    if (settings.format == OUTPUT_FORMAT_ASCII)
+    {
+        WinStat_Add(&pressureStat, pressure);
+        WinStat_Add(&tempStat, temp);
+        if ((pressureStat.count >= SUMMARY_WINDOW) && !Dumping() && !TimeSync_ReplyPending())
+        {
+            PrintSummary();
+        }
+    }
+#endif
+
+    // beide Ketten haben die gleiche Dezimierung und laufen im Gleichschritt.
+    Filter_Process(&tempFilter, temp, &temp);
+    if (!Filter_Process(&pressureFilter, pressure, &pressure))
+    {
+        return;
+    }
+
+    if (OUTPUT_SAMPLES && !Dumping() && !TimeSync_ReplyPending())
+    {
+        if (settings.format == OUTPUT_FORMAT_BINARY)
+        {
+            uint8 record[CODEC_MAX_RECORD];
+            uint64 t = TimeSync_Valid() ? TimeSync_ToHost(sample->tStart) : sample->tStart;
+            int32_t values[3] = { pressure, temp, (int32_t)(uint32)(t / 1000u) };
+            Out_Write(record, Codec_Encode(&telemetry, values, record));
+            return;
+        }
+
+        char buffer[50];
+        // nach dem Zeitabgleich Hostzeit, sonst Zeit seit Reset
+        uint64 ms = (TimeSync_Valid() ? TimeSync_ToHost(sample->tStart) : sample->tStart) / 1000u;
+        uint8 n = Fmt_U64(buffer, ms / 1000u);
+        Fmt_Print(&buffer[n], ".%03lu s\r\n", (uint32)(ms % 1000u));
+        UART_Print("Time: ");
+        UART_Print(buffer);
+
+        int32 temp_abs = (temp < 0) ? -temp : temp;
+        Fmt_Print(buffer, "Temperature: %s%ld.%ld0 C\r\n", (temp < 0) ? "-" : "", temp_abs / 10, temp_abs % 10);
+        UART_Print(buffer);
+
+        Fmt_Print(buffer, "Pressure: %ld Pa\r\n", pressure);
+        UART_Print(buffer);
+
+        int32 altitude = Altitude_FromPressure(pressure);
+        int32 alt_abs = (altitude < 0) ? -altitude : altitude;
+        Fmt_Print(buffer, "Altitude: %s%ld.%02ld m\r\n", (altitude < 0) ? "-" : "", alt_abs / 100, alt_abs % 100);
+        UART_Print(buffer);
+    }
 }
 
-int32 BMP180_CalculatePressure(int32 up, int32 B5)
+// Consumer der Queue, laeuft aus den Wartezeiten in acq.c
+static void ConsumeSamples(void)
 {
-    int32 B6 = B5 - 4000;
-    int32 X1 = (B2 * ((B6 * B6) >> 12)) >> 11;
-    int32 X2 = (AC2 * B6) >> 11;
-    int32 X3 = X1 + X2;
-    int32 B3 = (((((int32)AC1) * 4 + X3) + 2) / 4);
-    X1 = (AC3 * B6) >> 13;
-    X2 = (B1 * ((B6 * B6) >> 12)) >> 16;
-    X3 = ((X1 + X2) + 2) >> 2;
-    uint32 B4 = (AC4 * (uint32)(X3 + 32768)) >> 15;
-    uint32 B7 = ((uint32)up - B3) * 50000;
-    int32 P;
-    if (B7 < 0x80000000)
+    Acq_Sample sample;
+
+    // laeuft in jeder Wartepause: TS Antwort, sobald der Sendepuffer leer ist,
+    // aber nie mitten in die Nutzdaten eines Dumps
+    if (!Dumping())
     {
-        P = (B7 << 1) / B4;
+        TimeSync_Poll();
     }
-    else
+    if (SampleQ_Count(&sampleQueue) == 0)
     {
-        P = (B7 / B4) << 1;
+        return;
+    }
+    // Kompensation, Ausgabe und Log schnell, gewartet wird in acq.c langsam
+    Clock_Boost();
+    while (SampleQ_Pop(&sampleQueue, &sample))
+    {
+        Hib_SampleDone(&sample);
+        ProcessSample(&sample);
     }
-    X1 = (P >> 8) * (P >> 8);
-    X1 = (X1 * 3038) >> 16;
-    X2 = (-7357 * P) >> 16;
-    P = P + ((X1 + X2 + 3791) >> 4);
-    return P;
 }
 
+// Einstellungen nach einem Kommando uebernehmen, laeuft zwischen zwei Messungen
+static void ApplySettings(uint16 apply)
+{
+    char buffer[20];
+
+    // was noch in der Queue liegt, gehoert zu den alten Einstellungen
+    if (apply != 0)
+    {
+        ConsumeSamples();
+    }
+    if (apply & CMD_APPLY_ACQ)
+    {
+        Acq_SetMode(settings.mode);
+        Acq_SetPeriod(settings.periodUs);
+        Acq_ResetStats();
+    }
+    if (apply & CMD_APPLY_OSS)
+    {
+        // Rohwerte mit anderem OSS lassen sich nicht mehr kompensieren
+        BMP180_SetOss(settings.oss);
+        Log_Clear();
+    }
+    if (apply & CMD_APPLY_FILTER)
+    {
+        SetupFilters();
+    }
+    if (apply & CMD_APPLY_FORMAT)
+    {
+        Codec_ForceKeyframe(&telemetry);
+        WinStat_Reset(&pressureStat);
+        WinStat_Reset(&tempStat);
+    }
+    if ((apply & CMD_DUMP_LOG) && !Dumping())
+    {
+        Fmt_Print(buffer, "LOG %u\r\n", Log_StartDump());
+        UART_Print(buffer);
+    }
+    if ((apply & CMD_DUMP_TRACE) && !Dumping())
+    {
+        Fmt_Print(buffer, "TRACE %u\r\n", Trace_StartDump());
+        UART_Print(buffer);
+    }
+    if (apply & CMD_DUMP_STATS)
+    {
+        PrintStats();
+    }
+    if (apply & CMD_DUMP_MEM)
+    {
+        Mem_Report();
+    }
+    if (apply & CMD_DUMP_BOOT)
+    {
+        Boot_Report();
+    }
+}
 
-void BMP180_Init(void)
+#if BENCH_COMPENSATION
+static void BenchCompensation(void)
 {
-    I2C_Start();
-    UART_Start();
-    BMP180_ReadCalibrationData();
+    char buffer[80];
+    volatile int32 sink;
+    uint32 slow = 0;
+    uint32 fast = 0;
+    uint32 n = 0;
+    int16 ut;
+    int16 uts[24];
+    int32 ups[24];
+    int32 temps[24];
+    int32 pressures[24];
+
+    for (ut = 20000; ut < 32000; ut += 500)
+    {
+        int32 up = 20000 + ut;
+        int32 B5;
+
+        uint32 start = Perf_Cycles();
+        float t = BMP180_CalculateTemperature(ut, &B5);
+        sink = BMP180_CalculatePressure(up, B5) + (int32)t;
+        slow += Perf_Cycles() - start;
 
+        start = Perf_Cycles();
+        B5 = BMP180_CalculateB5Fast(ut);
+        sink = BMP180_CalculatePressure(up, B5) + BMP180_TemperatureX10(B5);
+        fast += Perf_Cycles() - start;
+
+        uts[n] = ut;
+        ups[n] = up;
+        n++;
+    }
+    (void)sink;
+
+    uint32 start = Perf_Cycles();
+    BMP180_CompensateBatch(uts, ups, temps, pressures, n);
+    uint32 batch = Perf_Cycles() - start;
+
+    Fmt_Print(buffer, "Bench: compensation %lu -> %lu cycles, batch %lu\r\n", slow / n, fast / n, batch / n);
+    UART_Print(buffer);
 }
+#endif
 
-void UART_Print(const char *string)
+#if BENCH_ALTITUDE
+static void BenchAltitude(void)
 {
-    UART_PutString(string);
+    char buffer[60];
+    volatile int32 sink;
+    uint32 n = 0;
+    int32 p;
+
+    uint32 start = Perf_Cycles();
+    for (p = 30000; p < 110000; p += 997)
+    {
+        sink = Altitude_FromPressure(p);
+        n++;
+    }
+    uint32 cycles = Perf_Cycles() - start;
+    (void)sink;
+
+    Fmt_Print(buffer, "Bench: altitude %lu cycles\r\n", cycles / n);
+    UART_Print(buffer);
 }
+#endif
+
+#if BENCH_SCHEDULER
+static void PrintSched(const char *name, const Sched *sched)
+{
+    char buffer[80];
+    uint32 rate = Sched_SamplesPerSecondX100(sched);
+    uint32 util = Sched_UtilizationX10(sched);
+
+    Fmt_Print(buffer, "Bench: sched %s %lu.%02lu S/s, bus %lu.%lu %%\r\n", name,
+            rate / 100u, rate % 100u, util / 10u, util % 10u);
+    UART_Print(buffer);
+}
+
+static void BenchScheduler(void)
+{
+    static Sched sched;
+    static Sched_Device devices[BENCH_SCHED_DEVICES];
+    uint8 i;
+
+    Sched_Init(&sched, Out_Poll);
+    for (i = 0; i < BENCH_SCHED_DEVICES; i++)
+    {
+        devices[i].step = Sched_SimStep;
+        devices[i].path = NULL;
+        devices[i].context = (void *)&Sched_simBmp180;
+        Sched_Add(&sched, &devices[i]);
+    }
+
+    for (i = 0; i < BENCH_SCHED_ROUNDS; i++)
+    {
+        Sched_RunSequential(&sched);
+    }
+    PrintSched("seq", &sched);
+
+    Sched_ResetStats(&sched);
+    for (i = 0; i < BENCH_SCHED_ROUNDS; i++)
+    {
+        Sched_RunInterleaved(&sched);
+    }
+    PrintSched("interleaved", &sched);
+}
+#endif
 
 int main(void)
 {
     CyGlobalIntEnable;
-    char buffer[50];
 
+    // Perf_Init() laeuft schon im Konstruktor von boot.c
+    Boot_Mark(BOOT_MAIN);
+    Clock_Init();
+    Time_Init();
+    Bus_Init();
+#if SENSOR_MUX_ADDR
+    Bus_Bind(&BMP180_device, BMP180_ADDR, Bus_AddMux(SENSOR_MUX_ADDR), SENSOR_MUX_CHANNEL);
+#endif
     BMP180_Init();
+    Boot_Mark(BOOT_SENSOR);
+    DefaultSettings();
+    Settings_Init(&settings);
+    BMP180_SetOss(settings.oss);
+    Acq_Init(settings.mode, ACQ_WAIT, settings.periodUs);
+    Acq_Prime();
+    Boot_Mark(BOOT_TRIGGER);
+
+    // alles Weitere im Schatten der ersten Wandlung
+    Out_Init();
+    Baud_Init();
+    SampleQ_Init(&sampleQueue);
+    Acq_SetConsumer(ConsumeSamples);
+    SetupFilters();
+    WinStat_Reset(&pressureStat);
+    WinStat_Reset(&tempStat);
+    Codec_InitEncoder(&telemetry, 3, TELEMETRY_KEY_INTERVAL, TELEMETRY_ORDER2);
+    Log_Init();
+    Rx_Init();
+    TimeSync_Init();
+    Altitude_SetSeaLevel(ALTITUDE_P0_DEFAULT);
+    Hib_Init();
+    Boot_Mark(BOOT_INIT);
+#if BENCH_COMPENSATION
+    BenchCompensation();
+#endif
+#if BENCH_ALTITUDE
+    BenchAltitude();
+#endif
+#if BENCH_SCHEDULER
+    BenchScheduler();
+#endif
 
     for (;;)
     {
-        int16 ut = BMP180_ReadRawTemperature();
-        int32 up = BMP180_ReadRawPressure();
-        int32 B5;
-        float temperature = BMP180_CalculateTemperature(ut, &B5);
-        int32 pressure = BMP180_CalculatePressure(up, B5);
-        int16 temp_int = (int16)temperature;
-        int16 temp_frac = (int16)((temperature - temp_int) * 100);
-        sprintf(buffer, "Temperature: %d.%02d C\r\n", temp_int, (temp_frac < 0 ? -temp_frac : temp_frac));
-        UART_Print(buffer);
+        // verarbeitet wird in den Wartezeiten der naechsten Messung (ConsumeSamples())
+        Acq_Produce(&sampleQueue);
+        if (!Boot_Done())
+        {
+            Boot_Mark(BOOT_FIRST_SAMPLE);
+            if (settings.format == OUTPUT_FORMAT_ASCII)
+            {
+                Boot_Report();
+            }
+        }
 
-        sprintf(buffer, "Pressure: %ld Pa\r\n", pressure);
-        UART_Print(buffer);
+        char line[RX_LINE_MAX];
+        uint64 rxTime;
+        while (Rx_GetLine(line, &rxTime))
+        {
+            // Antworten sind Text: vorher den Binaerblock schliessen
+            CloseTelemetry();
+            if (!TimeSync_Handle(line, rxTime))
+            {
+                ApplySettings(Cmd_Handle(line, &settings));
+            }
+        }
+        Log_DumpPoll();
+        Trace_DumpPoll();
 
-        CyDelay(2000);
+        // im Binaermodus wuerde Text den Delta Strom zerreissen
+        if ((settings.format == OUTPUT_FORMAT_ASCII) && !Dumping() && !TimeSync_ReplyPending() && (Acq_stats.samples > 0) &&
+            (Time_Us() - statsLast >= ACQ_STATS_PERIOD_US))
+        {
+            PrintStats();
+            Acq_ResetStats();
+            statsLast = Time_Us();
+        }
     }
 }
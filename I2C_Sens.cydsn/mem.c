@@ -0,0 +1,77 @@
+#include "mem.h"
+#include "out.h"
+#include "fmt.h"
+#include <errno.h>
+
+Mem_Stats Mem_stats;
+
+// aus cm3gcc.ld
+extern uint32 __cy_stack_limit[];
+extern uint32 __cy_stack[];
+extern uint8 end[];
+
+static uint8 *heapPointer = end;
+
+
+// laeuft ueber __libc_init_array() vor main(), nur unterhalb des eigenen Frames
+__attribute__((constructor))
+static void Mem_PaintStack(void)
+{
+    volatile uint32 *p = __cy_stack_limit;
+    uint32 *top = (uint32 *)(__get_MSP() - 32u);
+
+    while (p < top)
+    {
+        *p++ = MEM_STACK_PAINT;
+    }
+}
+
+uint32 Mem_StackSize(void)
+{
+    return (uint32)((uint8 *)__cy_stack - (uint8 *)__cy_stack_limit);
+}
+
+uint32 Mem_StackUsed(void)
+{
+    const volatile uint32 *p = __cy_stack_limit;
+
+    while ((p < __cy_stack) && (*p == MEM_STACK_PAINT))
+    {
+        p++;
+    }
+    return (uint32)((const uint8 *)__cy_stack - (const uint8 *)p);
+}
+
+// ersetzt die weak Version aus Cm3Start.c
+void *_sbrk(int nbytes)
+{
+    void *returnValue;
+
+    Mem_stats.sbrkCalls++;
+    // ohne Heap ist schon der Versuch ein Fehler
+    if (!CONFIG_HEAP_FREE && (((heapPointer + nbytes) - end) <= CYDEV_HEAP_SIZE))
+    {
+        returnValue = heapPointer;
+        heapPointer += nbytes;
+        Mem_stats.heapUsed = (uint32)(heapPointer - end);
+        return returnValue;
+    }
+
+    Mem_stats.sbrkFailures++;
+#if MEM_SBRK_TRAP
+    CyHalt(0u);
+#endif
+    errno = ENOMEM;
+    return (void *)-1;
+}
+
+void Mem_Report(void)
+{
+    char buffer[80];
+
+    Fmt_Print(buffer, "Mem: stack %lu/%lu bytes\r\n", Mem_StackUsed(), Mem_StackSize());
+    Out_Print(buffer);
+    Fmt_Print(buffer, "Mem: heap %lu/%u bytes, sbrk %lu calls, %lu failed\r\n",
+            Mem_stats.heapUsed, CYDEV_HEAP_SIZE, Mem_stats.sbrkCalls, Mem_stats.sbrkFailures);
+    Out_Print(buffer);
+}
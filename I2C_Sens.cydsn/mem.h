@@ -0,0 +1,30 @@
+#ifndef MEM_H
+#define MEM_H
+
+#include "project.h"
+#include "config.h"
+
+// RAM Verbrauch zur Laufzeit. Der Stack (CYDEV_STACK_SIZE, vom Hauptprogramm
+// und allen ISRs benutzt) wird vor main() mit MEM_STACK_PAINT gefuellt, die
+// hoechste je benutzte Stelle findet Mem_StackUsed(). _sbrk() aus Cm3Start.c
+// ist hier ersetzt und zaehlt mit, wer den Heap (CYDEV_HEAP_SIZE) benutzt.
+#define MEM_STACK_PAINT 0xA5A5A5A5u
+#define MEM_SBRK_TRAP   1       // 1: volles Heap haelt per CyHalt() an statt ENOMEM
+                                // mit CONFIG_HEAP_FREE schon der erste Aufruf
+
+typedef struct
+{
+    uint32 sbrkCalls;
+    uint32 sbrkFailures;
+    uint32 heapUsed;            // Bytes, die _sbrk() ausgegeben hat
+} Mem_Stats;
+
+extern Mem_Stats Mem_stats;
+
+uint32 Mem_StackSize(void);
+uint32 Mem_StackUsed(void);     // hoechster Stand seit Reset in Bytes
+
+// "Mem: ..." Zeilen ueber Out
+void Mem_Report(void);
+
+#endif /* MEM_H */
@@ -0,0 +1,102 @@
+#include "out.h"
+#include "hal.h"
+#include "baud.h"
+#include "timebase.h"
+
+static uint8 outBuffer[OUT_BUFFER_SIZE];
+static uint16 outHead;
+static uint16 outTail;
+static uint64 outEmptySince;    // seit wann der Hardware FIFO leer ist
+static uint8 outEmptySeen;
+
+uint32 Out_stalls;
+
+
+void Out_Init(void)
+{
+    outHead = 0;
+    outTail = 0;
+    outEmptySeen = 0;
+    Out_stalls = 0;
+    Hal_UartStart();
+}
+
+uint16 Out_Pending(void)
+{
+    return (uint16)((outHead - outTail + OUT_BUFFER_SIZE) % OUT_BUFFER_SIZE);
+}
+
+uint16 Out_Free(void)
+{
+    return (uint16)(OUT_BUFFER_SIZE - 1u - Out_Pending());
+}
+
+void Out_Poll(void)
+{
+    while ((outTail != outHead) && Hal_UartTxReady())
+    {
+        Hal_UartTxPut(outBuffer[outTail]);
+        outTail = (outTail + 1u) % OUT_BUFFER_SIZE;
+        outEmptySeen = 0;
+    }
+}
+
+void Out_Write(const uint8 *data, uint16 len)
+{
+    while (len--)
+    {
+        uint16 next = (outHead + 1u) % OUT_BUFFER_SIZE;
+        if (next == outTail)
+        {
+            Out_stalls++;
+            while (next == outTail)
+            {
+                Out_Poll();
+            }
+        }
+        outBuffer[outHead] = *data++;
+        outHead = next;
+    }
+    Out_Poll();
+}
+
+void Out_Print(const char *string)
+{
+    const char *end = string;
+    while (*end)
+    {
+        end++;
+    }
+    Out_Write((const uint8 *)string, (uint16)(end - string));
+}
+
+// Ist der FIFO leer, steckt das letzte Byte noch bis zu einer Zeichenzeit
+// im Schieberegister. UART_TX_STS_COMPLETE hilft nicht: es wird nach jedem
+// Byte gesetzt und beim Lesen geloescht, auch von Hal_UartTxReady().
+// Deshalb ab dem ersten leeren FIFO eine ganze Zeichenzeit (10 Bit) abwarten.
+uint8 Out_Idle(void)
+{
+    uint64 now;
+
+    if ((outTail != outHead) || !Hal_UartTxIdle())
+    {
+        outEmptySeen = 0;
+        return 0;
+    }
+    now = Time_Us();
+    if (!outEmptySeen)
+    {
+        outEmptySince = now;
+        outEmptySeen = 1;
+    }
+    return (now - outEmptySince) > (10000000u + Baud_Get() - 1u) / Baud_Get();
+}
+
+void Out_Flush(void)
+{
+    while (outTail != outHead)
+    {
+        Out_Poll();
+    }
+    while (!Out_Idle());
+}
@@ -0,0 +1,25 @@
+#ifndef OUT_H
+#define OUT_H
+
+#include "project.h"
+#include "config.h"
+
+// Sendepuffer vor dem 4 Byte UART FIFO. Out_Poll() schiebt Bytes nach,
+// waehrend der Sensor wandelt, statt in UART_PutString() zu blockieren.
+// Groesse OUT_BUFFER_SIZE in config.h.
+
+void Out_Init(void);
+void Out_Write(const uint8 *data, uint16 len);
+void Out_Print(const char *string);
+void Out_Poll(void);
+void Out_Flush(void);     // wartet bis auch das letzte Byte die UART verlassen hat
+// 1, wenn nichts mehr gesendet wird; erst dann darf die UART angehalten,
+// umgetaktet oder schlafen gelegt werden. Blockiert nicht.
+uint8 Out_Idle(void);
+uint16 Out_Pending(void);
+uint16 Out_Free(void);    // so viele Bytes gehen ohne Warten in Out_Write()
+
+// wie oft Out_Write() auf freien Platz warten musste
+extern uint32 Out_stalls;
+
+#endif /* OUT_H */
@@ -0,0 +1,21 @@
+#include "perf.h"
+
+#if CLOCK_GOVERNOR
+uint32 Perf_cpuHz = BCLK__BUS_CLK__HZ;
+uint32 Perf_cyclesPerUs = BCLK__BUS_CLK__HZ / 1000000u;
+#endif
+
+void Perf_Init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+#if CLOCK_GOVERNOR
+void Perf_SetHz(uint32 hz)
+{
+    Perf_cpuHz = hz;
+    Perf_cyclesPerUs = hz / 1000000u;
+}
+#endif
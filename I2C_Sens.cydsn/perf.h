@@ -0,0 +1,42 @@
+#ifndef PERF_H
+#define PERF_H
+
+#include "project.h"
+#include "config.h"
+
+#if CLOCK_GOVERNOR
+// aktueller CPU Takt, wird von clock.h beim Umschalten gesetzt
+extern uint32 Perf_cpuHz;
+extern uint32 Perf_cyclesPerUs;
+#define PERF_CPU_HZ         Perf_cpuHz
+#define PERF_CYCLES_PER_US  Perf_cyclesPerUs
+void Perf_SetHz(uint32 hz);
+#else
+#define PERF_CPU_HZ         BCLK__BUS_CLK__HZ
+#define PERF_CYCLES_PER_US  (PERF_CPU_HZ / 1000000u)
+#endif
+
+// DWT Zyklenzaehler des M3, laeuft mit dem CPU Takt und ueberlaeuft nach 2^32 Takten
+void Perf_Init(void);
+
+static inline uint32 Perf_Cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+static inline uint32 Perf_MsToCycles(uint32 ms)
+{
+    return ms * PERF_CYCLES_PER_US * 1000u;
+}
+
+static inline uint32 Perf_UsToCycles(uint32 us)
+{
+    return us * PERF_CYCLES_PER_US;
+}
+
+static inline uint32 Perf_CyclesToUs(uint32 cycles)
+{
+    return cycles / PERF_CYCLES_PER_US;
+}
+
+#endif /* PERF_H */
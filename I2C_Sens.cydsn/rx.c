@@ -0,0 +1,169 @@
+#include "rx.h"
+#include "timebase.h"
+#include "hal.h"
+
+uint32 Rx_overruns;
+
+#define RX_SYSTICK_SLOT 1u  // Slot 0 gehoert Time_Tick()
+
+// Kopf schreibt nur der SysTick Interrupt, Ende nur das Hauptprogramm.
+// Jede Zeile beginnt im Ring mit RX_MARK und ihrer Empfangszeit (8 Byte), so
+// bleiben Zeit und Zeile zusammen. Passt eine Zeile nicht mehr ganz in den
+// Ring oder geht in der Hardware ein Byte verloren, wird der Rest der Zeile
+// samt '\n' verworfen; Rx_GetLine() wirft den Anfang weg, sobald die naechste
+// Marke kommt.
+#define RX_MARK         0x00u
+#define RX_STAMP_BYTES  8u
+
+static uint8 rxBuffer[RX_BUFFER_SIZE];
+static volatile uint16 rxHead;
+static volatile uint16 rxTail;
+static uint8 rxLineStart;
+static uint8 rxDropLine;
+
+static char lineBuffer[RX_LINE_MAX];
+static uint8 lineLen;
+static uint64 lineTime;
+static uint8 lineStamped;
+
+
+void Rx_Init(void)
+{
+    rxHead = 0;
+    rxTail = 0;
+    rxLineStart = 1;
+    rxDropLine = 0;
+    lineLen = 0;
+    lineStamped = 0;
+    Rx_overruns = 0;
+    Hal_UartRxClear();
+    CySysTickSetCallback(RX_SYSTICK_SLOT, Rx_Poll);
+}
+
+static uint16 Rx_Free(void)
+{
+    return (uint16)(RX_BUFFER_SIZE - 1u - ((rxHead - rxTail + RX_BUFFER_SIZE) % RX_BUFFER_SIZE));
+}
+
+void Rx_Poll(void)
+{
+    uint8 status;
+
+    while ((status = Hal_UartRxStatus()) & HAL_RX_READY)
+    {
+        uint8 c = Hal_UartRxGet();
+        uint16 head = rxHead;
+        uint8 i;
+
+        if (c == RX_MARK)
+        {
+            continue;
+        }
+        if (rxLineStart)
+        {
+            uint64 now = Time_Us();
+
+            rxLineStart = 0;
+            rxDropLine = 0;
+            if (Rx_Free() < 1u + RX_STAMP_BYTES + 1u)
+            {
+                Rx_overruns++;
+                rxDropLine = 1;
+            }
+            else
+            {
+                rxBuffer[head] = RX_MARK;
+                for (i = 0; i < RX_STAMP_BYTES; i++)
+                {
+                    head = (head + 1u) % RX_BUFFER_SIZE;
+                    rxBuffer[head] = (uint8)(now >> (8u * i));
+                }
+                head = (head + 1u) % RX_BUFFER_SIZE;
+            }
+        }
+        if (status & HAL_RX_OVERRUN)
+        {
+            Rx_overruns++;
+            rxDropLine = 1;
+        }
+        if (c == '\n')
+        {
+            rxLineStart = 1;
+        }
+        if (rxDropLine)
+        {
+            continue;
+        }
+        if (Rx_Free() < (uint16)((head - rxHead + RX_BUFFER_SIZE) % RX_BUFFER_SIZE) + 1u)
+        {
+            Rx_overruns++;
+            rxDropLine = 1;
+            continue;
+        }
+        rxBuffer[head] = c;
+        // Marke, Zeit und Zeichen erst jetzt sichtbar machen
+        rxHead = (head + 1u) % RX_BUFFER_SIZE;
+    }
+}
+
+void Rx_Service(void)
+{
+    uint8 interruptState = CyEnterCriticalSection();
+    Rx_Poll();
+    CyExitCriticalSection(interruptState);
+}
+
+uint8 Rx_Idle(void)
+{
+    Rx_Service();
+    return rxLineStart;
+}
+
+uint8 Rx_GetLine(char *line, uint64 *time)
+{
+    while (rxTail != rxHead)
+    {
+        char c = (char)rxBuffer[rxTail];
+        rxTail = (rxTail + 1u) % RX_BUFFER_SIZE;
+
+        if (c == (char)RX_MARK)
+        {
+            // neue Zeile; ein angefangener Rest davor ist unvollstaendig
+            uint8 i;
+            lineTime = 0;
+            for (i = 0; i < RX_STAMP_BYTES; i++)
+            {
+                lineTime |= (uint64)rxBuffer[rxTail] << (8u * i);
+                rxTail = (rxTail + 1u) % RX_BUFFER_SIZE;
+            }
+            lineStamped = 1;
+            lineLen = 0;
+            continue;
+        }
+        if (!lineStamped || (c == '\r'))
+        {
+            continue;
+        }
+        if (c != '\n')
+        {
+            // zu lange Zeilen werden abgeschnitten
+            if (lineLen < RX_LINE_MAX - 1u)
+            {
+                lineBuffer[lineLen++] = c;
+            }
+            continue;
+        }
+
+        uint8 i;
+        for (i = 0; i < lineLen; i++)
+        {
+            line[i] = lineBuffer[i];
+        }
+        line[lineLen] = '\0';
+        lineLen = 0;
+        lineStamped = 0;
+        *time = lineTime;
+        return 1;
+    }
+    return 0;
+}
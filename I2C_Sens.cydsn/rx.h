@@ -0,0 +1,28 @@
+#ifndef RX_H
+#define RX_H
+
+#include "project.h"
+#include "config.h"
+
+// UART Empfang. Rx_Poll() leert den 4 Byte Hardware FIFO in einen Ring und
+// merkt sich, wann das erste Byte jeder Zeile ankam. Muss oft genug laufen
+// (bei 9600 Baud spaetestens alle 4 ms). Der RX Interrupt der UART ist im
+// TopDesign aus, deshalb haengt Rx_Init() Rx_Poll() an den 1 ms SysTick
+// (Time_Init() muss vorher laufen). Rx_GetLine() laeuft im Hauptprogramm.
+// Puffergroessen RX_* in config.h.
+
+extern uint32 Rx_overruns;
+
+void Rx_Init(void);
+void Rx_Poll(void);
+// Rx_Poll() aus dem Hauptprogramm, fuer Baudraten, bei denen 1 ms zu lang ist
+void Rx_Service(void);
+// vor einem Wechsel des Baudratentakts (clock.c): holt den Hardware FIFO ab
+// und gibt 1 zurueck, wenn gerade keine Zeile angefangen ist
+uint8 Rx_Idle(void);
+
+// Gibt 1 zurueck, wenn eine komplette Zeile (ohne \r\n) in line steht.
+// *time ist der Empfangszeitpunkt des ersten Zeichens in us.
+uint8 Rx_GetLine(char *line, uint64 *time);
+
+#endif /* RX_H */
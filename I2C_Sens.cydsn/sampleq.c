@@ -0,0 +1,49 @@
+#include "sampleq.h"
+
+void SampleQ_Init(SampleQ *q)
+{
+    q->head = 0;
+    q->tail = 0;
+    q->drops = 0;
+    q->highWater = 0;
+}
+
+uint8 SampleQ_Push(SampleQ *q, const Acq_Sample *sample)
+{
+    uint32 head = q->head;
+    uint32 used = head - q->tail;
+
+    if (used >= SAMPLEQ_SIZE)
+    {
+        q->drops++;
+        return 0;
+    }
+
+    q->record[head & (SAMPLEQ_SIZE - 1u)] = *sample;
+    // Datensatz muss sichtbar sein bevor head weiterzaehlt
+    __DMB();
+    q->head = head + 1u;
+
+    if (used + 1u > q->highWater)
+    {
+        q->highWater = used + 1u;
+    }
+    return 1;
+}
+
+uint8 SampleQ_Pop(SampleQ *q, Acq_Sample *sample)
+{
+    uint32 tail = q->tail;
+
+    if (tail == q->head)
+    {
+        return 0;
+    }
+
+    // head gelesen, erst danach den Datensatz
+    __DMB();
+    *sample = q->record[tail & (SAMPLEQ_SIZE - 1u)];
+    __DMB();
+    q->tail = tail + 1u;
+    return 1;
+}
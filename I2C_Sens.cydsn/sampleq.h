@@ -0,0 +1,37 @@
+#ifndef SAMPLEQ_H
+#define SAMPLEQ_H
+
+#include "project.h"
+#include "acq.h"
+#include "config.h"
+
+// Single Producer / Single Consumer Ring fuer Messwerte, Erfassung -> Verarbeitung.
+// Producer ist Acq_Produce(), Consumer die Funktion aus Acq_SetConsumer(), die
+// in den Wartezeiten der naechsten Messung laeuft (spaeter ggf. ISR -> main).
+// head schreibt nur der Producer, tail nur der Consumer. Beide sind freilaufende,
+// ausgerichtete 32 Bit Werte, deren Speicherung auf dem M3 atomar ist, es wird
+// also kein CyDisableInts() gebraucht. Groesse SAMPLEQ_SIZE in config.h.
+
+typedef struct SampleQ
+{
+    volatile uint32 head;
+    volatile uint32 tail;
+    uint32 drops;           // verworfene Messungen, weil der Ring voll war
+    uint32 highWater;       // maximaler Fuellstand
+    Acq_Sample record[SAMPLEQ_SIZE];
+} SampleQ;
+
+void SampleQ_Init(SampleQ *q);
+
+// Producer Seite, gibt 0 zurueck wenn der Ring voll ist
+uint8 SampleQ_Push(SampleQ *q, const Acq_Sample *sample);
+
+// Consumer Seite, gibt 0 zurueck wenn der Ring leer ist
+uint8 SampleQ_Pop(SampleQ *q, Acq_Sample *sample);
+
+static inline uint32 SampleQ_Count(const SampleQ *q)
+{
+    return q->head - q->tail;
+}
+
+#endif /* SAMPLEQ_H */
@@ -0,0 +1,162 @@
+#include "sched.h"
+#include "perf.h"
+
+// Zeiten aus den Bytes pro Zugriff inkl. Adressbytes bei 100 kHz (9 Bit = 90 us):
+//   0: Temperatur starten    W F4 2E                         3 Bytes
+//   1: UT lesen              W F6, R MSB LSB                 5 Bytes
+//      Druck starten         W F4 34                         3 Bytes
+//   2: UP lesen (OSS 0)      W F6, R MSB LSB                 5 Bytes
+// Wandlung Temperatur und Druck bei OSS 0 je 4.5 ms (Datenblatt)
+const Sched_SimDevice Sched_simBmp180 =
+{
+    { 270u, 720u, 450u },
+    { 4500u, 4500u, 0u }
+};
+
+
+void Sched_Init(Sched *sched, void (*idle)(void))
+{
+    sched->count = 0;
+    sched->idle = idle;
+    Sched_ResetStats(sched);
+}
+
+void Sched_ResetStats(Sched *sched)
+{
+    sched->stats.samples = 0;
+    sched->stats.cycles = 0;
+    sched->stats.busCycles = 0;
+}
+
+static uint8 Sched_Key(const Sched_Device *device)
+{
+    return (device->path != NULL) ? Bus_PathKey(device->path) : 0xFFu;
+}
+
+uint8 Sched_Add(Sched *sched, Sched_Device *device)
+{
+    uint8 i;
+
+    if (sched->count >= SCHED_MAX_DEVICES)
+    {
+        return 0;
+    }
+    // nach Pfad einsortieren, bei gleichem Pfad in Reihenfolge des Anmeldens
+    for (i = sched->count; (i > 0) && (Sched_Key(sched->device[i - 1u]) > Sched_Key(device)); i--)
+    {
+        sched->device[i] = sched->device[i - 1u];
+    }
+    sched->device[i] = device;
+    sched->count++;
+    return 1;
+}
+
+// eine Phase ausfuehren, gibt 1 zurueck solange das Geraet noch nicht fertig ist
+static uint8 Sched_Step(Sched *sched, Sched_Device *device)
+{
+    uint32 start = Perf_Cycles();
+    uint32 wait = device->step(device, device->phase++);
+    uint32 end = Perf_Cycles();
+
+    sched->stats.busCycles += end - start;
+    if (wait == 0)
+    {
+        sched->stats.samples++;
+        return 0;
+    }
+    device->due = end + Perf_UsToCycles(wait);
+    return 1;
+}
+
+static void Sched_WaitUntil(Sched *sched, uint32 due)
+{
+    while ((int32)(due - Perf_Cycles()) > 0)
+    {
+        if (sched->idle != NULL)
+        {
+            sched->idle();
+        }
+    }
+}
+
+void Sched_RunInterleaved(Sched *sched)
+{
+    uint32 start = Perf_Cycles();
+    uint8 active = 0;
+    uint8 busy[SCHED_MAX_DEVICES];
+    uint8 i;
+
+    for (i = 0; i < sched->count; i++)
+    {
+        sched->device[i]->phase = 0;
+        busy[i] = Sched_Step(sched, sched->device[i]);
+        active += busy[i];
+    }
+
+    while (active > 0)
+    {
+        uint8 next = 0xFFu;
+
+        // frueheste Faelligkeit, bei Gleichstand die Sortierreihenfolge
+        for (i = 0; i < sched->count; i++)
+        {
+            if (busy[i] && ((next == 0xFFu) || ((int32)(sched->device[i]->due - sched->device[next]->due) < 0)))
+            {
+                next = i;
+            }
+        }
+        Sched_WaitUntil(sched, sched->device[next]->due);
+        busy[next] = Sched_Step(sched, sched->device[next]);
+        active -= (uint8)!busy[next];
+    }
+    sched->stats.cycles += Perf_Cycles() - start;
+}
+
+void Sched_RunSequential(Sched *sched)
+{
+    uint32 start = Perf_Cycles();
+    uint8 i;
+
+    for (i = 0; i < sched->count; i++)
+    {
+        Sched_Device *device = sched->device[i];
+        device->phase = 0;
+        while (Sched_Step(sched, device))
+        {
+            Sched_WaitUntil(sched, device->due);
+        }
+    }
+    sched->stats.cycles += Perf_Cycles() - start;
+}
+
+uint32 Sched_SamplesPerSecondX100(const Sched *sched)
+{
+    if (sched->stats.cycles == 0)
+    {
+        return 0;
+    }
+    return (uint32)(((uint64)sched->stats.samples * PERF_CPU_HZ * 100u) / sched->stats.cycles);
+}
+
+uint32 Sched_UtilizationX10(const Sched *sched)
+{
+    if (sched->stats.cycles == 0)
+    {
+        return 0;
+    }
+    return (uint32)(((uint64)sched->stats.busCycles * 1000u) / sched->stats.cycles);
+}
+
+uint32 Sched_SimStep(Sched_Device *device, uint8 phase)
+{
+    const Sched_SimDevice *sim = (const Sched_SimDevice *)device->context;
+    uint32 start = Perf_Cycles();
+
+    if (phase >= SCHED_SIM_PHASES)
+    {
+        return 0;
+    }
+    // Busbelegung nachbilden
+    while ((Perf_Cycles() - start) < Perf_UsToCycles(sim->busUs[phase]));
+    return sim->convUs[phase];
+}
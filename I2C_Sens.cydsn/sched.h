@@ -0,0 +1,73 @@
+#ifndef SCHED_H
+#define SCHED_H
+
+#include "project.h"
+#include "bus.h"
+
+// Wandlungen mehrerer Sensoren ineinander verschachteln. Jedes Geraet laeuft
+// in Phasen: step() erledigt die Buszugriffe einer Phase (Ergebnis der letzten
+// Wandlung lesen, naechste starten) und gibt zurueck, wie lange die gestartete
+// Wandlung dauert, bzw. 0 wenn die Messung fertig ist.
+//
+// Sched_RunInterleaved() startet alle Geraete und bedient dann immer das
+// Geraet, dessen Wandlung als naechstes fertig ist. Waehrend ein Sensor
+// wandelt, ist der Bus fuer die anderen frei. Sched_RunSequential() ist der
+// bisherige Ablauf (starten, warten, lesen pro Geraet) als Vergleich.
+// Geraete werden nach Bus_PathKey() einsortiert, damit gleichzeitig faellige
+// Geraete hinter demselben Mux Kanal nacheinander drankommen.
+#define SCHED_MAX_DEVICES   8u
+
+typedef struct Sched_Device Sched_Device;
+
+struct Sched_Device
+{
+    uint32 (*step)(Sched_Device *device, uint8 phase);     // us bis zur naechsten Phase, 0 = fertig
+    const Bus_Device *path;     // nur zum Sortieren, darf NULL sein
+    void *context;
+    uint8 phase;
+    uint32 due;                 // Perf_Cycles(), ab wann die naechste Phase dran ist
+};
+
+typedef struct
+{
+    uint32 samples;
+    uint32 cycles;              // Gesamtzeit der Runden
+    uint32 busCycles;           // davon in step(), also auf dem Bus
+} Sched_Stats;
+
+typedef struct
+{
+    Sched_Device *device[SCHED_MAX_DEVICES];
+    uint8 count;
+    void (*idle)(void);         // waehrend gewartet wird, darf NULL sein
+    Sched_Stats stats;
+} Sched;
+
+void Sched_Init(Sched *sched, void (*idle)(void));
+uint8 Sched_Add(Sched *sched, Sched_Device *device);
+void Sched_ResetStats(Sched *sched);
+
+// eine Messung von jedem Geraet
+void Sched_RunInterleaved(Sched *sched);
+void Sched_RunSequential(Sched *sched);
+
+// Messungen pro Sekunde * 100 und Busauslastung in 0.1 %
+uint32 Sched_SamplesPerSecondX100(const Sched *sched);
+uint32 Sched_UtilizationX10(const Sched *sched);
+
+// Nachgebildeter Sensor fuer Vergleichsmessungen ohne Hardware: jede Phase
+// belegt den Bus fuer busUs[phase] und startet eine Wandlung von convUs[phase].
+#define SCHED_SIM_PHASES    3u
+
+typedef struct
+{
+    uint16 busUs[SCHED_SIM_PHASES];
+    uint16 convUs[SCHED_SIM_PHASES];    // 0 = Messung nach dieser Phase fertig
+} Sched_SimDevice;
+
+// BMP180 bei 100 kHz und OSS 0: Temperatur starten, UT lesen + Druck starten, UP lesen
+extern const Sched_SimDevice Sched_simBmp180;
+
+uint32 Sched_SimStep(Sched_Device *device, uint8 phase);
+
+#endif /* SCHED_H */
@@ -0,0 +1,119 @@
+#include "settings.h"
+#include "acq.h"
+#include "bmp180.h"
+#include <stddef.h>
+
+#define SETTINGS_FLASH_SIZE \
+    CY_EM_EEPROM_GET_PHYSICAL_SIZE(SETTINGS_EEPROM_SIZE, SETTINGS_WEAR_LEVELING, 0u)
+
+// Settings muss in den Em_EEPROM Bereich passen
+typedef uint8 Settings_SizeCheck[(sizeof(Settings) <= SETTINGS_EEPROM_SIZE) ? 1 : -1];
+
+CY_ALIGN(CY_FLASH_SIZEOF_ROW)
+static const uint8 settingsFlash[SETTINGS_FLASH_SIZE] = {0u};
+
+static cy_stc_eeprom_context_t eepromContext;
+static uint8 eepromReady;
+
+
+static uint16 Settings_Check(const Settings *settings)
+{
+    const uint8 *data = (const uint8 *)settings;
+    uint16 sum = 0;
+    uint16 i;
+
+    for (i = 0; i < offsetof(Settings, check); i++)
+    {
+        sum = (uint16)((sum << 1) | (sum >> 15)) + data[i];
+    }
+    return sum;
+}
+
+uint8 Settings_OssValid(uint32 oss)
+{
+#if BMP180_FIXED_OSS != BMP180_OSS_RUNTIME
+    return oss == BMP180_FIXED_OSS;
+#else
+    return oss <= BMP180_OSS_MAX;
+#endif
+}
+
+uint8 Settings_StageValid(uint8 type, uint32 param)
+{
+    switch (type)
+    {
+    case FILTER_NONE:
+        return 1;
+    case FILTER_IIR:
+        return param <= FILTER_IIR_MAX_K;
+    case FILTER_MEDIAN:
+    case FILTER_BOXCAR:
+        return (param > 0) && (param <= FILTER_WINDOW_MAX);
+    default:
+        return 0;
+    }
+}
+
+// ein Satz aus einer aelteren Firmware oder mit gekipptem Bit, das die
+// Pruefsumme nicht bemerkt, darf nichts einstellen, was kein Kommando koennte
+static uint8 Settings_Valid(const Settings *settings)
+{
+    uint8 i;
+
+    if (!Settings_OssValid(settings->oss) || ((settings->periodUs % 1000u) != 0) ||
+        ((settings->mode != ACQ_MODE_SEQUENTIAL) && (settings->mode != ACQ_MODE_PIPELINED)) ||
+        (settings->format > OUTPUT_FORMAT_BINARY) || (settings->decimation == 0))
+    {
+        return 0;
+    }
+    for (i = 0; i < FILTER_MAX_STAGES; i++)
+    {
+        if (!Settings_StageValid(settings->pressure[i].type, settings->pressure[i].param) ||
+            !Settings_StageValid(settings->temp[i].type, settings->temp[i].param))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+uint8 Settings_Init(Settings *settings)
+{
+    cy_stc_eeprom_config_t config;
+    Settings stored;
+
+    config.eepromSize = SETTINGS_EEPROM_SIZE;
+    config.wearLevelingFactor = SETTINGS_WEAR_LEVELING;
+    config.redundantCopy = 0u;
+    config.blockingWrite = 1u;
+    config.userFlashStartAddr = (uint32)settingsFlash;
+
+    eepromReady = (Cy_Em_EEPROM_Init(&config, &eepromContext) == CY_EM_EEPROM_SUCCESS);
+    if (!eepromReady)
+    {
+        return 0;
+    }
+
+    if ((Cy_Em_EEPROM_Read(0u, &stored, sizeof(stored), &eepromContext) != CY_EM_EEPROM_SUCCESS) ||
+        (stored.magic != SETTINGS_MAGIC) || (stored.version != SETTINGS_VERSION) ||
+        (stored.check != Settings_Check(&stored)) || !Settings_Valid(&stored))
+    {
+        return 0;
+    }
+    *settings = stored;
+    return 1;
+}
+
+uint8 Settings_Save(Settings *settings)
+{
+    if (!eepromReady)
+    {
+        return 0;
+    }
+
+    settings->magic = SETTINGS_MAGIC;
+    settings->version = SETTINGS_VERSION;
+    settings->reserved = 0;
+    settings->check = Settings_Check(settings);
+    return Cy_Em_EEPROM_Write(0u, settings, sizeof(*settings), &eepromContext) == CY_EM_EEPROM_SUCCESS;
+}
@@ -0,0 +1,52 @@
+#ifndef SETTINGS_H
+#define SETTINGS_H
+
+#include "project.h"
+#include "filter.h"
+
+#define OUTPUT_FORMAT_ASCII  0u
+#define OUTPUT_FORMAT_BINARY 1u     // Delta/Varint Strom, siehe codec.h
+
+// Laufzeit Einstellungen, per Kommando aenderbar (cmd.h) und im Flash per
+// Em_EEPROM abgelegt. Das Em_EEPROM liegt ohne eigene Komponente in einem
+// zeilenweise ausgerichteten const Array (2 fache Wear Leveling).
+#define SETTINGS_MAGIC          0x5345u
+#define SETTINGS_VERSION        1u
+#define SETTINGS_EEPROM_SIZE    64u
+#define SETTINGS_WEAR_LEVELING  2u
+
+typedef struct
+{
+    uint8 type;     // FILTER_NONE = Stufe leer
+    uint8 param;
+} Settings_Stage;
+
+typedef struct
+{
+    uint16 magic;
+    uint8 version;
+    uint8 oss;
+    uint32 periodUs;            // 0 = freilaufend
+    uint8 mode;                 // ACQ_MODE_*
+    uint8 format;               // OUTPUT_FORMAT_*
+    uint8 decimation;
+    uint8 reserved;
+    Settings_Stage pressure[FILTER_MAX_STAGES];
+    Settings_Stage temp[FILTER_MAX_STAGES];
+    uint16 check;               // Summe ueber alle Bytes davor
+} Settings;
+
+// Em_EEPROM einrichten. Liegt ein gueltiger Satz im Flash, wird *settings
+// damit ueberschrieben und 1 zurueckgegeben, sonst bleiben die Vorgaben.
+// Gueltig heisst: Pruefsumme stimmt und jeder Wert liegt in den Grenzen der
+// Kommandos (cmd.c), sonst wird der ganze Satz verworfen.
+uint8 Settings_Init(Settings *settings);
+
+// Grenzen fuer OSS und eine Filterstufe, gemeinsam fuer Kommandos und Laden
+uint8 Settings_OssValid(uint32 oss);
+uint8 Settings_StageValid(uint8 type, uint32 param);
+
+// schreibt in den Flash, blockiert dabei fuer die Dauer eines Zeilen Schreibens
+uint8 Settings_Save(Settings *settings);
+
+#endif /* SETTINGS_H */
@@ -0,0 +1,66 @@
+#include "timebase.h"
+#include "perf.h"
+
+static volatile uint64 timeMs;
+static uint64 timeBaseUs;       // Stand beim letzten Taktwechsel
+static uint32 ticksPerMs;
+static uint32 ticksPerUs;
+
+
+static void Time_Tick(void)
+{
+    timeMs++;
+}
+
+void Time_Init(void)
+{
+    timeMs = 0;
+    timeBaseUs = 0;
+    ticksPerMs = PERF_CPU_HZ / 1000u;
+    ticksPerUs = PERF_CPU_HZ / 1000000u;
+    CySysTickStart();
+    // CySysTickStart() laedt freq/1000, die Periode ist aber Reload + 1 Takte
+    CySysTickSetReload(ticksPerMs - 1u);
+    CySysTickClear();
+    CySysTickSetCallback(0, Time_Tick);
+}
+
+uint64 Time_Us(void)
+{
+    uint8 interruptState = CyEnterCriticalSection();
+    uint64 ms = timeMs;
+    uint32 value = SysTick->VAL;
+
+    // Ueberlauf schon passiert, aber der Interrupt ist noch nicht gelaufen
+    if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+    {
+        ms++;
+        value = SysTick->VAL;
+    }
+    CyExitCriticalSection(interruptState);
+
+    return timeBaseUs + (ms * 1000u) + (((ticksPerMs - 1u) - value) / ticksPerUs);
+}
+
+void Time_SetClock(uint32 hz)
+{
+    uint8 interruptState = CyEnterCriticalSection();
+
+    // angefangene ms mitnehmen, dann mit neuer Periode von vorne zaehlen
+    timeBaseUs = Time_Us();
+    timeMs = 0;
+    ticksPerMs = hz / 1000u;
+    ticksPerUs = hz / 1000000u;
+    CySysTickSetReload(ticksPerMs - 1u);
+    CySysTickClear();
+    SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+    CyExitCriticalSection(interruptState);
+}
+
+void Time_Advance(uint64 us)
+{
+    uint8 interruptState = CyEnterCriticalSection();
+
+    timeBaseUs += us;
+    CyExitCriticalSection(interruptState);
+}
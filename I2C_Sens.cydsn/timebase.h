@@ -0,0 +1,22 @@
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include "project.h"
+
+// Monotone Mikrosekunden Zeitbasis aus dem SysTick (1 ms Interrupt) plus
+// Unterteilung ueber den aktuellen Zaehlerstand. 64 Bit laufen nicht ueber.
+void Time_Init(void);
+uint64 Time_Us(void);
+
+// nach einem Wechsel des CPU Takts (clock.h), die Zeit laeuft ohne Sprung weiter
+void Time_SetClock(uint32 hz);
+
+// Zeit, in der der SysTick stand (Sleep, hib.h), nachtragen
+void Time_Advance(uint64 us);
+
+static inline uint32 Time_Us32(void)
+{
+    return (uint32)Time_Us();
+}
+
+#endif /* TIMEBASE_H */
@@ -0,0 +1,133 @@
+#include "trace.h"
+#include "timebase.h"
+#include "out.h"
+
+#define TRACE_MASK  (TRACE_SIZE - 1u)
+
+uint8 Trace_capture;
+uint32 Trace_records;
+uint32 Trace_dropped;
+
+static uint8 traceBuffer[TRACE_SIZE];
+static uint16 traceHead;        // laufen frei, Index mit TRACE_MASK
+static uint16 traceTail;
+static uint32 traceLastUs;
+static uint8 dumping;
+static uint8 captureBefore;     // Zustand vor dem Auslesen
+
+
+void Trace_Init(void)
+{
+    Trace_capture = 1;
+    Trace_records = 0;
+    Trace_dropped = 0;
+    dumping = 0;
+    Trace_Clear();
+}
+
+void Trace_Clear(void)
+{
+    traceHead = 0;
+    traceTail = 0;
+    traceLastUs = Time_Us32();
+    if (dumping)
+    {
+        dumping = 0;
+        Trace_capture = captureBefore;
+    }
+}
+
+uint16 Trace_Used(void)
+{
+    return (uint16)(traceHead - traceTail);
+}
+
+static void Trace_Put(uint8 value)
+{
+    traceBuffer[traceHead & TRACE_MASK] = value;
+    traceHead++;
+}
+
+void Trace_Record(uint8 addr, uint8 dir, const uint8 *data, uint8 len, uint8 result)
+{
+    uint16 size = TRACE_HEADER + len;
+    uint32 now;
+    uint32 dt;
+    uint8 i;
+
+    if (!Trace_capture || (size > TRACE_SIZE))
+    {
+        return;
+    }
+    // aelteste Eintraege verwerfen bis Platz ist, Laenge steht in Byte 2
+    while (Trace_Used() + size > TRACE_SIZE)
+    {
+        traceTail += TRACE_HEADER + traceBuffer[(traceTail + 2u) & TRACE_MASK];
+        Trace_dropped++;
+    }
+
+    now = Time_Us32();
+    dt = now - traceLastUs;
+    traceLastUs = now;
+    if (dt > 0xFFFFu)
+    {
+        dt = 0xFFFFu;
+    }
+
+    Trace_Put((uint8)((addr << 1) | dir));
+    Trace_Put(result);
+    Trace_Put(len);
+    Trace_Put((uint8)dt);
+    Trace_Put((uint8)(dt >> 8));
+    for (i = 0; i < len; i++)
+    {
+        Trace_Put(data[i]);
+    }
+    Trace_records++;
+}
+
+uint16 Trace_StartDump(void)
+{
+    if (!dumping)
+    {
+        captureBefore = Trace_capture;
+        Trace_capture = 0;
+        dumping = 1;
+    }
+    return Trace_Used();
+}
+
+uint8 Trace_Dumping(void)
+{
+    return dumping;
+}
+
+void Trace_DumpPoll(void)
+{
+    uint16 n;
+    uint16 pos;
+
+    if (!dumping)
+    {
+        return;
+    }
+
+    n = Out_Free();
+    if (n > Trace_Used())
+    {
+        n = Trace_Used();
+    }
+    // nur bis zum Pufferende, der Rest beim naechsten Aufruf
+    pos = traceTail & TRACE_MASK;
+    if (n > TRACE_SIZE - pos)
+    {
+        n = TRACE_SIZE - pos;
+    }
+    Out_Write(&traceBuffer[pos], n);
+    traceTail += n;
+
+    if (Trace_Used() == 0)
+    {
+        Trace_Clear();
+    }
+}
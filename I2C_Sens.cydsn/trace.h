@@ -0,0 +1,36 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "project.h"
+#include "config.h"
+
+// Mitschnitt aller I2C Teil-Transfers (I2C_MasterWriteBuf/I2C_MasterReadBuf)
+// in einem RAM Ring, Groesse TRACE_SIZE in config.h. Ist der Ring voll,
+// fallen die aeltesten Eintraege heraus. Ein Eintrag:
+//
+//   Byte 0     Adresse << 1 | 1 bei Lesen
+//   Byte 1     Ergebnis: BUS_OK, BUS_ERR_NAK oder TRACE_RETRY (wird wiederholt)
+//   Byte 2     Anzahl Datenbytes n
+//   Byte 3..4  us seit dem vorigen Eintrag, little endian, bei 0xFFFF begrenzt
+//   Byte 5..   n Datenbytes (geschrieben bzw. gelesen)
+//
+// Zum Auslesen haelt Trace_StartDump() die Aufzeichnung an, Trace_DumpPoll()
+// schickt den Ring wie Log_DumpPoll() nach und nach ueber Out und leert ihn.
+#define TRACE_READ          0x01u
+#define TRACE_RETRY         0xFFu
+#define TRACE_HEADER        5u
+
+extern uint8 Trace_capture;     // 0: nichts aufzeichnen
+extern uint32 Trace_records;    // aufgezeichnete Eintraege
+extern uint32 Trace_dropped;    // davon wieder ueberschrieben
+
+void Trace_Init(void);
+void Trace_Clear(void);
+void Trace_Record(uint8 addr, uint8 dir, const uint8 *data, uint8 len, uint8 result);
+uint16 Trace_Used(void);
+
+uint16 Trace_StartDump(void);   // Anzahl Bytes, die gesendet werden
+void Trace_DumpPoll(void);
+uint8 Trace_Dumping(void);
+
+#endif /* TRACE_H */
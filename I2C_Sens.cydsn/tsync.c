@@ -0,0 +1,164 @@
+#include "tsync.h"
+#include "timebase.h"
+#include "out.h"
+#include "fmt.h"
+#include "hal.h"
+
+TimeSync_Stats TimeSync_stats;
+
+static uint8 syncValid;
+static uint64 pendingT1;
+static uint64 pendingT2;
+static uint64 pendingT3;
+static uint8 pendingValid;
+static uint8 replyPending;
+
+static uint64 refDevice;        // Bezugspunkt der Driftschaetzung
+static int64 refOffset;
+static uint64 lastDevice;       // letzter guter Austausch
+static int64 lastOffset;
+
+
+static uint8 TimeSync_Prefix(const char **line, const char *prefix)
+{
+    const char *s = *line;
+    while (*prefix)
+    {
+        if (*s++ != *prefix++)
+        {
+            return 0;
+        }
+    }
+    if (*s != ' ')
+    {
+        return 0;
+    }
+    *line = s;
+    return 1;
+}
+
+void TimeSync_Poll(void)
+{
+    char buffer[80];
+    uint8 n = 0;
+
+    // t3 gilt fuer das erste Byte der Antwort. Erst senden, wenn davor nichts
+    // mehr im Sendepuffer steht und der FIFO Platz hat, dann geht 'T' sofort
+    // in die UART. Der Rest wird danach formatiert, das dauert weniger als ein Zeichen.
+    if (!replyPending || (Out_Pending() != 0) || !Hal_UartTxReady())
+    {
+        return;
+    }
+    pendingT3 = Time_Us();
+    Out_Write((const uint8 *)"T", 1);
+
+    buffer[n++] = 'S';
+    buffer[n++] = ' ';
+    n += Fmt_U64(&buffer[n], pendingT1);
+    buffer[n++] = ' ';
+    n += Fmt_U64(&buffer[n], pendingT2);
+    buffer[n++] = ' ';
+    n += Fmt_U64(&buffer[n], pendingT3);
+    buffer[n++] = '\r';
+    buffer[n++] = '\n';
+    Out_Write((const uint8 *)buffer, n);
+    replyPending = 0;
+    pendingValid = 1;
+}
+
+uint8 TimeSync_ReplyPending(void)
+{
+    return replyPending;
+}
+
+static void TimeSync_Update(uint64 t4)
+{
+    int64 t1 = (int64)pendingT1;
+    int64 t2 = (int64)pendingT2;
+    int64 t3 = (int64)pendingT3;
+    int64 delay = ((int64)t4 - t1) - (t3 - t2);
+    int64 offset = ((t2 - t1) + (t3 - (int64)t4)) / 2;
+
+    pendingValid = 0;
+    if ((delay < 0) || (delay > TSYNC_MAX_DELAY_US))
+    {
+        TimeSync_stats.rejected++;
+        return;
+    }
+
+    TimeSync_stats.exchanges++;
+    TimeSync_stats.offsetUs = offset;
+    TimeSync_stats.delayUs = (uint32)delay;
+
+    if (!syncValid)
+    {
+        refDevice = pendingT2;
+        refOffset = offset;
+        syncValid = 1;
+    }
+    else
+    {
+        uint64 span = pendingT2 - refDevice;
+        if (span >= TSYNC_MIN_SPAN_US)
+        {
+            TimeSync_stats.driftPpb = (int32)(((offset - refOffset) * 1000000000) / (int64)span);
+        }
+        if (span >= TSYNC_MAX_SPAN_US)
+        {
+            refDevice = pendingT2;
+            refOffset = offset;
+        }
+    }
+    lastDevice = pendingT2;
+    lastOffset = offset;
+}
+
+void TimeSync_Init(void)
+{
+    syncValid = 0;
+    pendingValid = 0;
+    replyPending = 0;
+    TimeSync_stats.exchanges = 0;
+    TimeSync_stats.rejected = 0;
+    TimeSync_stats.offsetUs = 0;
+    TimeSync_stats.delayUs = 0;
+    TimeSync_stats.driftPpb = 0;
+}
+
+uint8 TimeSync_Handle(const char *line, uint64 rxTime)
+{
+    uint64 t1;
+    uint64 t4;
+
+    if (TimeSync_Prefix(&line, "TS1"))
+    {
+        if (Fmt_ParseU64(&line, &t1) && (rxTime != 0))
+        {
+            pendingT1 = t1;
+            pendingT2 = rxTime;
+            pendingValid = 0;
+            replyPending = 1;
+        }
+        return 1;
+    }
+    if (TimeSync_Prefix(&line, "TS2"))
+    {
+        if (Fmt_ParseU64(&line, &t1) && Fmt_ParseU64(&line, &t4) && pendingValid && (t1 == pendingT1))
+        {
+            TimeSync_Update(t4);
+        }
+        return 1;
+    }
+    return 0;
+}
+
+uint8 TimeSync_Valid(void)
+{
+    return syncValid;
+}
+
+uint64 TimeSync_ToHost(uint64 deviceUs)
+{
+    int64 offset = lastOffset + (((int64)(deviceUs - lastDevice) * TimeSync_stats.driftPpb) / 1000000000);
+    return (uint64)((int64)deviceUs - offset);
+}
@@ -0,0 +1,45 @@
+#ifndef TSYNC_H
+#define TSYNC_H
+
+#include "project.h"
+
+// NTP aehnlicher Zeitabgleich mit dem Host ueber die UART, Zeiten in us.
+// Zeitpunkte gelten jeweils fuer das erste Zeichen einer Zeile.
+//
+//   Host -> Geraet:  "TS1 <t1>"             t1 = Hostzeit beim Senden
+//   Geraet -> Host:  "TS <t1> <t2> <t3>"    t2 = Empfang, t3 = Senden (Geraetezeit)
+//   Host -> Geraet:  "TS2 <t1> <t4>"        t4 = Hostzeit beim Empfang der Antwort
+//
+// Nach TS2 kennt das Geraet Offset und Laufzeit des Austauschs. Aus mehreren
+// Austauschen wird die Drift geschaetzt, Hostzeit = Geraetezeit - Offset(t).
+#define TSYNC_MAX_DELAY_US  200000u     // Austausche mit mehr Laufzeit verwerfen
+#define TSYNC_MIN_SPAN_US   10000000u   // Drift erst ab 10 s Abstand schaetzen
+#define TSYNC_MAX_SPAN_US   600000000u  // Bezugspunkt fuer die Drift alle 10 min neu
+
+typedef struct
+{
+    uint32 exchanges;
+    uint32 rejected;
+    int64 offsetUs;     // Geraet - Host beim letzten Austausch
+    uint32 delayUs;
+    int32 driftPpb;     // Gang der Geraeteuhr gegenueber dem Host
+} TimeSync_Stats;
+
+extern TimeSync_Stats TimeSync_stats;
+
+void TimeSync_Init(void);
+
+// Bearbeitet TS1/TS2 Zeilen, gibt 0 zurueck wenn die Zeile nicht dazugehoert
+uint8 TimeSync_Handle(const char *line, uint64 rxTime);
+
+// Die Antwort auf TS1 geht erst raus, wenn der Sendepuffer leer ist, ohne
+// darauf zu warten. TimeSync_Poll() oft aufrufen (in den Wartezeiten), und
+// solange TimeSync_ReplyPending() nichts anderes senden, sonst kann der Puffer
+// bei voller Ausgabe nie leer werden.
+void TimeSync_Poll(void);
+uint8 TimeSync_ReplyPending(void);
+
+uint8 TimeSync_Valid(void);
+uint64 TimeSync_ToHost(uint64 deviceUs);
+
+#endif /* TSYNC_H */
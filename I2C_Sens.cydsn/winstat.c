@@ -0,0 +1,80 @@
+#include "winstat.h"
+
+static uint32 WinStat_Sqrt(uint64 x)
+{
+    uint64 result = 0;
+    uint64 bit = (uint64)1 << 62;
+
+    while (bit > x)
+    {
+        bit >>= 2;
+    }
+    while (bit != 0)
+    {
+        if (x >= result + bit)
+        {
+            x -= result + bit;
+            result = (result >> 1) + bit;
+        }
+        else
+        {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32)result;
+}
+
+void WinStat_Reset(WinStat *w)
+{
+    w->count = 0;
+    w->sum = 0;
+    w->sumSq = 0;
+}
+
+void WinStat_Add(WinStat *w, int32 x)
+{
+    if (w->count == 0)
+    {
+        w->ref = x;
+        w->min = x;
+        w->max = x;
+    }
+    else if (x < w->min)
+    {
+        w->min = x;
+    }
+    else if (x > w->max)
+    {
+        w->max = x;
+    }
+
+    int64 d = (int64)x - w->ref;
+    w->sum += d;
+    w->sumSq += (uint64)(d * d);
+    w->count++;
+}
+
+void WinStat_Get(const WinStat *w, WinStat_Summary *summary)
+{
+    int64 n = w->count;
+
+    summary->count = w->count;
+    if (n == 0)
+    {
+        summary->min = 0;
+        summary->max = 0;
+        summary->mean = 0;
+        summary->stddev = 0;
+        return;
+    }
+    summary->min = w->min;
+    summary->max = w->max;
+
+    int64 half = (w->sum >= 0) ? n / 2 : -(n / 2);
+    summary->mean = w->ref + (int32)((w->sum + half) / n);
+
+    // Summe d^2 - (Summe d)^2 / n = n * Varianz
+    uint64 nVar = w->sumSq - (uint64)((w->sum * w->sum) / n);
+    summary->stddev = WinStat_Sqrt((nVar + (uint64)(n / 2)) / (uint64)n);
+}
@@ -0,0 +1,32 @@
+#ifndef WINSTAT_H
+#define WINSTAT_H
+
+#include "project.h"
+
+// Min/Max/Mittelwert/Standardabweichung ueber ein Fenster, Ganzzahl und inkrementell.
+// Summiert wird die Abweichung vom ersten Wert im Fenster, damit bleiben die
+// Summen klein und die Varianz ist auch bei ~100000 Pa exakt (kein Ausloeschen).
+typedef struct
+{
+    uint32 count;
+    int32 ref;
+    int32 min;
+    int32 max;
+    int64 sum;      // Summe (x - ref)
+    uint64 sumSq;   // Summe (x - ref)^2
+} WinStat;
+
+typedef struct
+{
+    uint32 count;
+    int32 min;
+    int32 max;
+    int32 mean;     // gerundet, Einheit wie die Eingangswerte
+    uint32 stddev;
+} WinStat_Summary;
+
+void WinStat_Reset(WinStat *w);
+void WinStat_Add(WinStat *w, int32 x);
+void WinStat_Get(const WinStat *w, WinStat_Summary *summary);
+
+#endif /* WINSTAT_H */
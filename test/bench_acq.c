@@ -0,0 +1,153 @@
+// Erfassung (acq.c) gegen den nachgebildeten BMP180 mit einer UART, die in
+// simulierter Zeit sendet (Host_uartBaud): Messrate sequentiell und
+// pipelined, ohne Ausgabe und mit der Ausgabe von main.c bei OSS 0. Die
+// Ausgabe wird wie in main.c aus den Wartezeiten erzeugt; Stats einmal
+// alle ACQ_STATS_INTERVAL_OLD Messungen wie frueher, einmal alle
+// ACQ_STATS_PERIOD_US. Zeigt, ab wann die UART die Rate bestimmt.
+
+#include <string.h>
+#include "test.h"
+#include "acq.h"
+#include "bmp180.h"
+#include "bus.h"
+#include "out.h"
+#include "perf.h"
+#include "sampleq.h"
+#include "timebase.h"
+
+#define RUN_US                  60000000u
+#define DECIMATION              8u      // OUTPUT_DECIMATION in main.c
+#define SUMMARY_WINDOW          256u
+#define SUMMARY_BYTES           80u     // zwei Zeilen PrintSummary()
+#define STATS_BYTES             385u    // PrintStats() ohne Busfehler und Kanaele
+#define BIN_BYTES               5u      // Telemetrie je Ausgabe, test_codec
+#define ACQ_STATS_INTERVAL_OLD  32u
+
+#define TEXT_NONE               0u
+#define TEXT_ASCII              1u
+#define TEXT_BIN                2u
+
+#define STATS_NONE              0u
+#define STATS_SAMPLES           1u
+#define STATS_TIME              2u
+
+typedef struct
+{
+    const char *name;
+    uint8 mode;
+    uint32 baud;
+    uint8 text;
+    uint8 stats;
+} Config;
+
+static const Config configs[] =
+{
+    { "sequential, no output",          ACQ_MODE_SEQUENTIAL, 0u,      TEXT_NONE,  STATS_NONE },
+    { "pipelined, no output",           ACQ_MODE_PIPELINED,  0u,      TEXT_NONE,  STATS_NONE },
+    { "ASCII 9600, stats / 32 samples", ACQ_MODE_PIPELINED,  9600u,   TEXT_ASCII, STATS_SAMPLES },
+    { "ASCII 9600, stats / 10 s",       ACQ_MODE_PIPELINED,  9600u,   TEXT_ASCII, STATS_TIME },
+    { "ASCII 115200, stats / 10 s",     ACQ_MODE_PIPELINED,  115200u, TEXT_ASCII, STATS_TIME },
+    { "BIN 9600",                       ACQ_MODE_PIPELINED,  9600u,   TEXT_BIN,   STATS_NONE },
+};
+
+static SampleQ queue;
+static const Config *config;
+static uint32 consumed;
+static uint8 filler[STATS_BYTES];
+
+// Textausgabe je dezimierter Messung wie ProcessSample()
+static void Output(const Acq_Sample *sample)
+{
+    char buffer[100];
+    int n;
+
+    if (config->text == TEXT_BIN)
+    {
+        Out_Write(filler, BIN_BYTES);
+        return;
+    }
+    n = snprintf(buffer, sizeof(buffer), "Time: %lu.%03lu s\r\nTemperature: 15.00 C\r\nPressure: 69964 Pa\r\n"
+                 "Altitude: 3016.72 m\r\n", (unsigned long)(sample->tStart / 1000000u),
+                 (unsigned long)(sample->tStart / 1000u % 1000u));
+    Out_Write((const uint8 *)buffer, (uint16)n);
+}
+
+static void Consume(void)
+{
+    Acq_Sample sample;
+
+    while (SampleQ_Pop(&queue, &sample))
+    {
+        consumed++;
+        if (config->text == TEXT_NONE)
+        {
+            continue;
+        }
+        if ((config->text == TEXT_ASCII) && (consumed % SUMMARY_WINDOW == 0))
+        {
+            Out_Write(filler, SUMMARY_BYTES);
+        }
+        if (consumed % DECIMATION == 0)
+        {
+            Output(&sample);
+        }
+    }
+}
+
+int main(void)
+{
+    uint8 c;
+
+    memset(filler, 'x', sizeof(filler));
+    for (c = 0; c < sizeof(configs) / sizeof(configs[0]); c++)
+    {
+        uint64 start;
+        uint64 statsLast;
+        uint32 samples;
+        uint32 bytes;
+        uint32 stalls;
+        double seconds;
+
+        config = &configs[c];
+        Perf_Init();
+        Host_uartBaud = config->baud;
+        Out_Init();
+        Bus_Init();
+        BMP180_Init();
+        BMP180_SetOss(0);
+        SampleQ_Init(&queue);
+        Acq_Init(config->mode, ACQ_WAIT_EOC, 0);
+        Acq_SetConsumer(Consume);
+        consumed = 0;
+        Host_uartLength = 0;
+        stalls = Out_stalls;
+
+        start = Time_Us();
+        statsLast = start;
+        samples = 0;
+        while (Time_Us() - start < RUN_US)
+        {
+            Acq_Produce(&queue);
+            samples++;
+            // wie die Hauptschleife in main.c
+            if (((config->stats == STATS_SAMPLES) && (samples % ACQ_STATS_INTERVAL_OLD == 0)) ||
+                ((config->stats == STATS_TIME) && (Time_Us() - statsLast >= ACQ_STATS_PERIOD_US)))
+            {
+                Out_Write(filler, STATS_BYTES);
+                statsLast = Time_Us();
+            }
+        }
+        seconds = (double)(Time_Us() - start) / 1e6;
+        bytes = Host_uartLength;
+        printf("acq: %-32s %6.1f S/s", config->name, samples / seconds);
+        if (config->baud > 0)
+        {
+            printf(", uart %3.0f %% of %lu baud, stalls %lu", 100.0 * bytes * 10.0 / (config->baud * seconds),
+                   (unsigned long)config->baud, (unsigned long)(Out_stalls - stalls));
+        }
+        printf("\n");
+        CHECK(BMP180_errors == 0);
+        CHECK(queue.drops == 0);
+    }
+    return TestResult("bench_acq");
+}
@@ -0,0 +1,132 @@
+// Batch Kompensation fuer Rohwert Puffer: BMP180_CompensateBatch() (wie auf
+// dem Target, B5 je gleichem UT nur einmal) und BMP180_CompensateBatchWide()
+// (Bloecke ohne Sprung, vom Compiler vektorisiert). Beide muessen bitgenau
+// zu den Datenblattformeln sein, dann Durchsatz in Messwerten pro Sekunde.
+
+#include <stdlib.h>
+#include "test.h"
+#include "bmp180.h"
+
+#define SAMPLES     (4u * 1024u * 1024u)
+#define ROUNDS      5u
+
+static uint32 seed = 1u;
+
+static uint32 Random(void)
+{
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 8;
+}
+
+// wie aus dem Log: Temperatur aendert sich selten, Druck rauscht um ein paar LSB
+static void FillLog(int16 *ut, int32 *up, uint32 count)
+{
+    int32 t = 27898;
+    int32 p = 23843 << BMP180_oss;
+    uint32 i;
+
+    for (i = 0; i < count; i++)
+    {
+        if ((Random() & 15u) == 0)
+        {
+            t += (int32)(Random() % 3u) - 1;
+        }
+        p += (int32)(Random() % 9u) - 4;
+        ut[i] = (int16)t;
+        up[i] = p;
+    }
+}
+
+// ueber den ganzen Bereich, jedes UT anders: etwa -40..85 C und 300..1100 hPa
+static void FillRandom(int16 *ut, int32 *up, uint32 count)
+{
+    uint32 i;
+
+    for (i = 0; i < count; i++)
+    {
+        ut[i] = (int16)(AC6 + (int32)(Random() % 9000u));
+        up[i] = (int32)(12000u + Random() % 48000u) << BMP180_oss;
+    }
+}
+
+static double Throughput(uint8 wide, const int16 *ut, const int32 *up, int32 *t, int32 *p)
+{
+    double best = 0;
+    uint32 round;
+
+    for (round = 0; round < ROUNDS; round++)
+    {
+        double start = TestNowNs();
+        double rate;
+        if (wide)
+        {
+            BMP180_CompensateBatchWide(ut, up, t, p, SAMPLES);
+        }
+        else
+        {
+            BMP180_CompensateBatch(ut, up, t, p, SAMPLES);
+        }
+        rate = SAMPLES / ((TestNowNs() - start) * 1e-9);
+        best = (rate > best) ? rate : best;
+    }
+    return best;
+}
+
+int main(void)
+{
+    int16 *ut = malloc(SAMPLES * sizeof(int16));
+    int32 *up = malloc(SAMPLES * sizeof(int32));
+    int32 *t1 = malloc(SAMPLES * sizeof(int32));
+    int32 *p1 = malloc(SAMPLES * sizeof(int32));
+    int32 *t2 = malloc(SAMPLES * sizeof(int32));
+    int32 *p2 = malloc(SAMPLES * sizeof(int32));
+    uint8 oss;
+    uint8 random;
+    uint32 i;
+
+    // Datenblattbeispiel
+    AC1 = 408; AC2 = -72; AC3 = -14383; AC4 = 32741; AC5 = 32757; AC6 = 23153;
+    B1 = 6190; B2 = 4; MB = -32768; MC = -8711; MD = 2868;
+
+    for (oss = 0; oss <= BMP180_OSS_MAX; oss++)
+    {
+        BMP180_SetOss(oss);
+        for (random = 0; random < 2u; random++)
+        {
+            uint32 mismatch = 0;
+
+            if (random)
+            {
+                FillRandom(ut, up, SAMPLES);
+            }
+            else
+            {
+                FillLog(ut, up, SAMPLES);
+            }
+            BMP180_CompensateBatch(ut, up, t1, p1, SAMPLES);
+            BMP180_CompensateBatchWide(ut, up, t2, p2, SAMPLES);
+            for (i = 0; i < SAMPLES; i++)
+            {
+                int32 B5;
+                float temperature = BMP180_CalculateTemperature(ut[i], &B5);
+                int32 pressure = BMP180_CalculatePressure(up[i], B5);
+                (void)temperature;
+                if ((t1[i] != t2[i]) || (p1[i] != p2[i]) || (p1[i] != pressure) || (t1[i] != BMP180_TemperatureX10(B5)))
+                {
+                    mismatch++;
+                }
+            }
+            CHECK(mismatch == 0);
+
+            printf("OSS %u %s: batch %.1f M/s, wide %.1f M/s\n", oss, random ? "random" : "log   ",
+                   Throughput(0, ut, up, t1, p1) * 1e-6, Throughput(1, ut, up, t2, p2) * 1e-6);
+        }
+    }
+    free(ut);
+    free(up);
+    free(t1);
+    free(p1);
+    free(t2);
+    free(p2);
+    return TestResult("bench_batch");
+}
@@ -0,0 +1,75 @@
+// bus.c, bmp180.c und trace.c unveraendert gegen den nachgebildeten BMP180
+// (hal_sim.c): Messwerte pruefen, dann Rechenzeit auf dem PC und simulierte
+// Buszeit je Messung.
+
+#include "test.h"
+#include "bmp180.h"
+#include "bus.h"
+#include "perf.h"
+#include "timebase.h"
+
+#define SAMPLES     200000u
+
+static int32 Measure(int32 *temperature)
+{
+    int16 ut;
+    int32 up;
+    int32 B5;
+
+    BMP180_StartTemperature();
+    while (!BMP180_ConversionDone())
+    {
+    }
+    ut = (int16)BMP180_ReadResult();
+    BMP180_StartPressure();
+    while (!BMP180_ConversionDone())
+    {
+    }
+    up = BMP180_ReadPressureResult();
+
+    B5 = BMP180_CalculateB5Fast(ut);
+    *temperature = BMP180_TemperatureX10(B5);
+    return BMP180_CalculatePressure(up, B5);
+}
+
+int main(void)
+{
+    uint8 oss;
+
+    Perf_Init();
+    Bus_Init();
+    BMP180_Init();
+    CHECK(BMP180_errors == 0);
+    CHECK((AC1 == 408) && (AC4 == 32741u) && (MD == 2868));
+
+    for (oss = 0; oss <= BMP180_OSS_MAX; oss++)
+    {
+        int32 temperature;
+        int32 pressure;
+        uint32 i;
+        uint32 transactions;
+        uint64 simStart;
+        double start;
+        double ns;
+
+        BMP180_SetOss(oss);
+        pressure = Measure(&temperature);
+        // Datenblattbeispiel, +-2 LSB Rauschen im Simulator
+        CHECK((temperature >= 148) && (temperature <= 152));
+        CHECK((pressure >= 69940) && (pressure <= 69990));
+
+        transactions = Bus_stats.transactions;
+        simStart = Time_Us();
+        start = TestNowNs();
+        for (i = 0; i < SAMPLES; i++)
+        {
+            pressure = Measure(&temperature);
+        }
+        ns = (TestNowNs() - start) / SAMPLES;
+        printf("OSS %u: %.0f ns/sample host, %.0f samples/s, sim %lu us/sample, %lu transactions/sample, P %ld Pa\n",
+               oss, ns, 1e9 / ns, (unsigned long)((Time_Us() - simStart) / SAMPLES),
+               (unsigned long)((Bus_stats.transactions - transactions) / SAMPLES), (long)pressure);
+    }
+    CHECK(BMP180_errors == 0);
+    return TestResult("bench_driver");
+}
@@ -0,0 +1,110 @@
+// Host Decoder fuer den UART Strom im Binaermodus (FORMAT BIN).
+//
+//     codec_decode < mitschnitt.bin > messwerte.csv
+//     codec_decode --log < log.bin > rohwerte.csv
+//
+// Telemetrie (main.c): seq,pressure_pa,temp_0.1c,ms. Textzeilen zwischen den
+// Bloecken (Antworten, "LOG n", "TRACE n") gehen nach stderr. Nach "LOG n"
+// folgen n Bytes Log (log.h: ut, up), nach "TRACE n" n Bytes Trace, die hier
+// uebersprungen werden. Mit --log ist die ganze Eingabe ein Log Dump.
+// Verworfene Bloecke stehen in der Zusammenfassung auf stderr.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "project.h"
+#include "codec.h"
+
+// wie TELEMETRY_KEY_INTERVAL/TELEMETRY_ORDER2 in main.c und LOG_KEY_INTERVAL/LOG_CHANNELS in log.h
+#define TELEMETRY_CHANNELS      3u
+#define TELEMETRY_KEY_INTERVAL  16u
+#define TELEMETRY_ORDER2        0x04u
+#define LOG_CHANNELS            2u
+#define LOG_KEY_INTERVAL        32u
+
+static void Telemetry(void *context, uint32_t seq, const int32_t *values)
+{
+    (void)context;
+    printf("%lu,%ld,%ld,%lu\n", (unsigned long)seq, (long)values[0], (long)values[1], (unsigned long)(uint32)values[2]);
+}
+
+static void LogRecord(void *context, uint32_t seq, const int32_t *values)
+{
+    (void)context;
+    printf("log,%lu,%ld,%ld\n", (unsigned long)seq, (long)values[0], (long)values[1]);
+}
+
+static void Summary(const char *name, const Codec_Decoder *dec)
+{
+    fprintf(stderr, "%s: %lu blocks, %lu records, %lu rejected, %lu bytes outside blocks\n", name,
+            (unsigned long)dec->blocks, (unsigned long)dec->records, (unsigned long)dec->rejected,
+            (unsigned long)dec->skipped);
+}
+
+int main(int argc, char **argv)
+{
+    static Codec_Decoder telemetry;
+    static Codec_Decoder log;
+    char line[64];
+    uint8 lineLength = 0;
+    unsigned long payload = 0;
+    uint8 payloadLog = 0;
+    int c;
+
+    Codec_InitDecoder(&telemetry, TELEMETRY_CHANNELS, TELEMETRY_KEY_INTERVAL, TELEMETRY_ORDER2, Telemetry, 0);
+    Codec_InitDecoder(&log, LOG_CHANNELS, LOG_KEY_INTERVAL, 0, LogRecord, 0);
+
+    if ((argc > 1) && (strcmp(argv[1], "--log") == 0))
+    {
+        while ((c = getchar()) != EOF)
+        {
+            Codec_Decode(&log, (uint8)c);
+        }
+        Summary("log", &log);
+        return 0;
+    }
+
+    while ((c = getchar()) != EOF)
+    {
+        if (payload > 0)
+        {
+            payload--;
+            if (payloadLog)
+            {
+                Codec_Decode(&log, (uint8)c);
+            }
+            continue;
+        }
+
+        uint8 idle = (telemetry.length == 0);
+        Codec_Decode(&telemetry, (uint8)c);
+        if (!idle || (telemetry.length != 0))
+        {
+            lineLength = 0;
+            continue;
+        }
+
+        // Text ausserhalb der Bloecke
+        if (c == '\n')
+        {
+            line[lineLength] = 0;
+            fprintf(stderr, "%s\n", line);
+            if (sscanf(line, "LOG %lu", &payload) == 1)
+            {
+                payloadLog = 1;
+            }
+            else if (sscanf(line, "TRACE %lu", &payload) == 1)
+            {
+                payloadLog = 0;
+            }
+            lineLength = 0;
+        }
+        else if ((c != '\r') && (lineLength < sizeof(line) - 1u))
+        {
+            line[lineLength++] = (char)c;
+        }
+    }
+    Summary("telemetry", &telemetry);
+    Summary("log", &log);
+    return 0;
+}
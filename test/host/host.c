@@ -0,0 +1,198 @@
+#include "project.h"
+#include "perf.h"
+#include "timebase.h"
+
+// Ersatz fuer perf.c und timebase.c auf dem PC, dazu UART und Power Manager;
+// alles laeuft auf Host_cycles
+
+uint64 Host_cycles;
+Host_Dwt Host_dwt;
+uint8 Host_uartOut[HOST_UART_SIZE];
+uint32 Host_uartLength;
+
+uint32 Host_uartBaud;
+
+static uint64 timeAdvanced;     // Time_Advance(), im Schlaf zaehlt Host_cycles nicht weiter
+static uint8 uartFifo;          // Zeichen im FIFO und Schieberegister (Host_uartBaud)
+static uint64 uartDone;         // Host_cycles, wann das vorderste draussen ist
+
+
+void Perf_Init(void)
+{
+    Host_cycles = 0;
+    Host_sleptCycles = 0;
+    timeAdvanced = 0;
+    uartFifo = 0;
+}
+
+void Time_Init(void)
+{
+}
+
+// kostet wie das Lesen von DWT, damit Warteschleifen auf die Zeit weiterkommen
+uint64 Time_Us(void)
+{
+    Host_cycles += HOST_READ_CYCLES;
+    return Host_cycles / (BCLK__BUS_CLK__HZ / 1000000u) + timeAdvanced;
+}
+
+void Time_SetClock(uint32 hz)
+{
+    (void)hz;
+}
+
+void Time_Advance(uint64 us)
+{
+    timeAdvanced += us;
+}
+
+// --- UART ----------------------------------------------------------------
+
+static uint64 Host_UartCharCycles(void)
+{
+    return 10u * (uint64)BCLK__BUS_CLK__HZ / Host_uartBaud;
+}
+
+static void Host_UartDrain(void)
+{
+    while ((uartFifo > 0) && (Host_cycles >= uartDone))
+    {
+        uartFifo--;
+        uartDone += Host_UartCharCycles();
+    }
+}
+
+uint8 Host_UartTxStatus(void)
+{
+    uint8 status = 0;
+
+    if (Host_uartBaud == 0)
+    {
+        return UART_TX_STS_COMPLETE | UART_TX_STS_FIFO_EMPTY | UART_TX_STS_FIFO_NOT_FULL;
+    }
+    Host_cycles += HOST_READ_CYCLES;
+    Host_UartDrain();
+    if (uartFifo == 0)
+    {
+        status |= UART_TX_STS_COMPLETE | UART_TX_STS_FIFO_EMPTY;
+    }
+    if (uartFifo < HOST_UART_FIFO)
+    {
+        status |= UART_TX_STS_FIFO_NOT_FULL;
+    }
+    return status;
+}
+
+void Host_UartTx(uint8 c)
+{
+    if (Host_uartLength < HOST_UART_SIZE)
+    {
+        Host_uartOut[Host_uartLength] = c;
+    }
+    Host_uartLength++;
+    if (Host_uartBaud == 0)
+    {
+        return;
+    }
+    Host_UartDrain();
+    if (uartFifo == 0)
+    {
+        uartDone = Host_cycles + Host_UartCharCycles();
+    }
+    uartFifo++;
+}
+
+// --- Power Manager -------------------------------------------------------
+// Der CTW wird nur beim Setzen von CY_PM_CTW_EN neu gestartet, wie auf dem
+// Chip. Ereignisse liegen bei ctwStart + k * Intervall (echte Zeit).
+
+uint64 Host_sleptCycles;
+uint8 Host_pmTwCfg1;
+uint8 Host_pmTwCfg2;
+
+static uint8 ctwEnabled;
+static uint64 ctwStart;
+static uint64 ctwSeen;          // Ereignisse bis zum letzten CyPmReadStatus()
+
+static uint64 Host_CtwCycles(void)
+{
+    return ((uint64)1u << (Host_pmTwCfg1 & 0x0Fu)) * BCLK__BUS_CLK__HZ / HOST_ILO_HZ;
+}
+
+// CY_PM_CTW_EN wird ausserhalb der Funktionen direkt geschrieben
+static void Host_CtwSync(void)
+{
+    uint8 enabled = (Host_pmTwCfg2 & CY_PM_CTW_EN) != 0;
+
+    if (enabled && !ctwEnabled)
+    {
+        ctwStart = Host_cycles + Host_sleptCycles;
+        ctwSeen = 0;
+    }
+    ctwEnabled = enabled;
+}
+
+static uint64 Host_CtwEvents(void)
+{
+    Host_CtwSync();
+    if (!ctwEnabled)
+    {
+        return ctwSeen;
+    }
+    return (Host_cycles + Host_sleptCycles - ctwStart) / Host_CtwCycles();
+}
+
+void CyPmCtwSetInterval(uint8 ctwInterval)
+{
+    Host_CtwSync();
+    Host_pmTwCfg2 &= (uint8)~CY_PM_CTW_IE;
+    if (Host_pmTwCfg2 & CY_PM_CTW_EN)
+    {
+        if (Host_pmTwCfg1 != ctwInterval)
+        {
+            Host_pmTwCfg2 &= (uint8)~CY_PM_CTW_EN;
+            Host_CtwSync();
+            Host_pmTwCfg1 = ctwInterval;
+            Host_pmTwCfg2 |= CY_PM_CTW_EN;
+        }
+    }
+    else
+    {
+        Host_pmTwCfg1 = ctwInterval;
+        Host_pmTwCfg2 |= CY_PM_CTW_EN;
+    }
+    Host_CtwSync();
+}
+
+// Ereignis seit dem letzten Lesen, wird beim Lesen geloescht
+uint8 CyPmReadStatus(uint8 mask)
+{
+    uint64 events = Host_CtwEvents();
+    uint8 status = (events > ctwSeen) ? CY_PM_CTW_INT : 0u;
+
+    ctwSeen = events;
+    return status & mask;
+}
+
+// schlaeft bis zum naechsten CTW Ereignis, ohne Weckquelle gar nicht
+void CyPmSleep(uint8 wakeupTime, uint16 wakeupSource)
+{
+    uint64 next;
+
+    (void)wakeupTime;
+    Host_CtwSync();
+    if (!(wakeupSource & PM_SLEEP_SRC_CTW) || !(Host_pmTwCfg2 & CY_PM_CTW_IE) || !ctwEnabled)
+    {
+        return;
+    }
+    next = ctwStart + (Host_CtwEvents() + 1u) * Host_CtwCycles();
+    Host_sleptCycles = next - Host_cycles;
+}
+
+void CyPmSaveClocks(void)
+{
+}
+
+void CyPmRestoreClocks(void)
+{
+}
@@ -0,0 +1,201 @@
+#ifndef PROJECT_H
+#define PROJECT_H
+
+// Ersatz fuer das generierte project.h beim Bauen auf dem PC (test/Makefile).
+// Nur Typen, Konstanten und die wenigen Komponenten Funktionen, die hal.h,
+// perf.h und die Treiber benutzen. Zeit ist simuliert: Host_cycles zaehlt
+// Takte bei BCLK__BUS_CLK__HZ, CyDelay()/CyDelayUs() und jedes Lesen des
+// Zyklenzaehlers oder von Time_Us() ruecken sie vor, damit Warteschleifen
+// weiterkommen.
+// Bytes an die UART landen in Host_uartOut.
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint8_t  uint8;
+typedef uint16_t uint16;
+typedef uint32_t uint32;
+typedef uint64_t uint64;
+typedef int8_t   int8;
+typedef int16_t  int16;
+typedef int32_t  int32;
+typedef int64_t  int64;
+
+#define CY_NOINIT
+#define LO8(x)                  ((uint8) ((x) & 0xFFu))
+#define HI8(x)                  ((uint8) ((uint16)(x) >> 8))
+
+#define BCLK__BUS_CLK__HZ       24000000u
+#define HOST_READ_CYCLES        24u     // jedes Lesen von DWT->CYCCNT kostet 1 us
+
+// --- Zeit ----------------------------------------------------------------
+extern uint64 Host_cycles;
+
+typedef struct
+{
+    uint32 CYCCNT;
+} Host_Dwt;
+
+extern Host_Dwt Host_dwt;
+
+static inline Host_Dwt *Host_DwtRead(void)
+{
+    Host_cycles += HOST_READ_CYCLES;
+    Host_dwt.CYCCNT = (uint32)Host_cycles;
+    return &Host_dwt;
+}
+
+#define DWT                     (Host_DwtRead())
+
+static inline void CyDelay(uint32 ms)
+{
+    Host_cycles += (uint64)ms * (BCLK__BUS_CLK__HZ / 1000u);
+}
+
+static inline void CyDelayUs(uint16 us)
+{
+    Host_cycles += (uint64)us * (BCLK__BUS_CLK__HZ / 1000000u);
+}
+
+// Speicherbarriere wie auf dem M3, fuer Tests mit mehreren Threads
+#define __DMB()                 __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+static inline uint8 CyEnterCriticalSection(void)
+{
+    return 0;
+}
+
+static inline void CyExitCriticalSection(uint8 state)
+{
+    (void)state;
+}
+
+// --- Power Manager (Sleep, CTW) -----------------------------------------
+// Im Schlaf stehen DWT und SysTick: die verschlafene Zeit zaehlt
+// Host_sleptCycles, die echte Zeit ist Host_RealUs(). Der CTW laeuft mit
+// HOST_ILO_HZ (absichtlich nicht 1 kHz) ab dem Setzen von CY_PM_CTW_EN.
+#define HOST_ILO_HZ             900u
+
+#define PM_SLEEP_TIME_NONE      (0x00u)
+#define PM_SLEEP_SRC_CTW        (0x0800u)
+#define CY_PM_CTW_IE            (0x08u)
+#define CY_PM_CTW_EN            (0x04u)
+#define CY_PM_CTW_INT           (0x02u)
+
+extern uint64 Host_sleptCycles;
+extern uint8 Host_pmTwCfg1;
+extern uint8 Host_pmTwCfg2;
+
+#define CY_PM_TW_CFG1_REG       Host_pmTwCfg1
+#define CY_PM_TW_CFG2_REG       Host_pmTwCfg2
+
+void CyPmCtwSetInterval(uint8 ctwInterval);
+uint8 CyPmReadStatus(uint8 mask);
+void CyPmSleep(uint8 wakeupTime, uint16 wakeupSource);
+void CyPmSaveClocks(void);
+void CyPmRestoreClocks(void);
+
+static inline uint64 Host_RealUs(void)
+{
+    return (Host_cycles + Host_sleptCycles) / (BCLK__BUS_CLK__HZ / 1000000u);
+}
+
+// --- I2C Master (nur Konstanten, Zugriffe gehen mit HAL_SIM an hal_sim.c) --
+#define I2C_MODE_COMPLETE_XFER  (0x00u)
+#define I2C_MODE_REPEAT_START   (0x01u)
+#define I2C_MODE_NO_STOP        (0x02u)
+
+#define I2C_MSTAT_RD_CMPLT      (0x01u)
+#define I2C_MSTAT_WR_CMPLT      (0x02u)
+#define I2C_MSTAT_XFER_INP      (0x04u)
+#define I2C_MSTAT_XFER_HALT     (0x08u)
+#define I2C_MSTAT_ERR_MASK      (0xF0u)
+#define I2C_MSTAT_ERR_ADDR_NAK  (0x20u)
+#define I2C_MSTAT_ERR_ARB_LOST  (0x40u)
+#define I2C_MSTAT_ERR_XFER      (0x80u)
+
+#define I2C_MSTR_NO_ERROR       (0x00u)
+#define I2C_MSTR_BUS_BUSY       (0x01u)
+#define I2C_MSTR_ERR_ARB_LOST   (0x04u)
+
+// --- UART ----------------------------------------------------------------
+#define UART_TX_STS_COMPLETE        (0x01u)
+#define UART_TX_STS_FIFO_EMPTY      (0x02u)
+#define UART_TX_STS_FIFO_NOT_FULL   (0x08u)
+#define UART_RX_STS_OVERRUN         (0x10u)
+#define UART_RX_STS_FIFO_NOTEMPTY   (0x20u)
+#define UART_OVER_SAMPLE_COUNT      (8u)
+
+#define HOST_UART_SIZE          65536u
+
+extern uint8 Host_uartOut[HOST_UART_SIZE];
+extern uint32 Host_uartLength;
+
+static inline void UART_Start(void)
+{
+}
+
+static inline void UART_Stop(void)
+{
+}
+
+static inline void UART_Enable(void)
+{
+}
+
+static inline void UART_Sleep(void)
+{
+}
+
+static inline void UART_Wakeup(void)
+{
+}
+
+// Host_uartBaud 0: sendet sofort, der FIFO ist immer leer. Sonst 10 Bit je
+// Zeichen in simulierter Zeit und HOST_UART_FIFO Byte FIFO wie die UART
+// Komponente; jede Statusabfrage kostet dann HOST_READ_CYCLES, damit
+// Warteschleifen auf den FIFO weiterkommen.
+#define HOST_UART_FIFO          4u
+
+extern uint32 Host_uartBaud;
+
+uint8 Host_UartTxStatus(void);
+void Host_UartTx(uint8 c);
+
+static inline uint8 UART_ReadTxStatus(void)
+{
+    return Host_UartTxStatus();
+}
+
+static inline void UART_WriteTxData(uint8 c)
+{
+    Host_UartTx(c);
+}
+
+static inline uint8 UART_ReadRxStatus(void)
+{
+    return 0;
+}
+
+static inline uint8 UART_ReadRxData(void)
+{
+    return 0;
+}
+
+static inline void UART_ClearRxBuffer(void)
+{
+}
+
+static inline void CySysTickSetCallback(uint32 number, void (*function)(void))
+{
+    (void)number;
+    (void)function;
+}
+
+static inline void UART_IntClock_SetDividerRegister(uint16 divider, uint8 restart)
+{
+    (void)divider;
+    (void)restart;
+}
+
+#endif /* PROJECT_H */
@@ -0,0 +1,36 @@
+#ifndef TEST_H
+#define TEST_H
+
+// gemeinsame Hilfen der Host Tests und Benchmarks (test/Makefile)
+
+#include <stdio.h>
+#include <time.h>
+
+static int testFailures;
+
+#define CHECK(cond) \
+    do \
+    { \
+        if (!(cond)) \
+        { \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            testFailures++; \
+        } \
+    } while (0)
+
+// Ergebnis fuer main(), 0 = alles gut
+static inline int TestResult(const char *name)
+{
+    printf("%s: %s\n", name, testFailures ? "FAILED" : "ok");
+    return testFailures ? 1 : 0;
+}
+
+// Wanduhr in ns fuer Benchmarks
+static inline double TestNowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+#endif /* TEST_H */
@@ -0,0 +1,53 @@
+// altitude.c gegen die barometrische Hoehenformel in double: jede Druckstufe
+// (1 Pa) von 300 bis 1100 hPa fuer Meereshoehendruck 950..1050 hPa, und
+// Altitude_SeaLevelPressure() fuer 0..8000 m.
+
+#include <math.h>
+#include "test.h"
+#include "altitude.h"
+
+#define MAX_ERROR_CM    7.0     // Zusage in altitude.h
+#define MAX_ERROR_PA    2.0
+
+static double Reference(double p, double p0)
+{
+    return 4433000.0 * (1.0 - pow(p / p0, 1.0 / 5.255));
+}
+
+int main(void)
+{
+    double worst = 0;
+    double worstP0 = 0;
+    int32 p0;
+    int32 p;
+    int32 h;
+
+    for (p0 = 95000; p0 <= 105000; p0 += 250)
+    {
+        Altitude_SetSeaLevel(p0);
+        CHECK(Altitude_GetSeaLevel() == p0);
+        for (p = 30000; p <= 110000; p++)
+        {
+            double error = fabs(Altitude_FromPressure(p) - Reference(p, p0));
+            if (error > worst)
+            {
+                worst = error;
+            }
+        }
+    }
+    printf("altitude: worst %.2f cm\n", worst);
+    CHECK(worst < MAX_ERROR_CM);
+
+    for (h = 0; h <= 800000; h += 50)
+    {
+        double exact = 101325.0 * pow(1.0 - h / 4433000.0, 5.255);
+        double error = fabs(Altitude_SeaLevelPressure((int32)lround(exact), h) - 101325.0);
+        if (error > worstP0)
+        {
+            worstP0 = error;
+        }
+    }
+    printf("sea level: worst %.2f Pa\n", worstP0);
+    CHECK(worstP0 <= MAX_ERROR_PA);
+    return TestResult("test_altitude");
+}
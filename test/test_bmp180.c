@@ -0,0 +1,209 @@
+// BMP180_CalculateB5Fast() und BMP180_CompensateBatch() gegen die
+// Datenblattformeln in BMP180_CalculateTemperature()/BMP180_CalculatePressure(),
+// bitgenau fuer mehrere Kalibrierungen: B5 fuer jedes UT im Bereich, der Druck
+// bei OSS 0 fuer jedes UP zu jedem UT_STEP_OSS0. UT, bei OSS 1..3 fuer jedes
+// UT und UP in Schritten von UP_STEP << oss. Danach Zeit je Aufruf.
+
+#include "test.h"
+#include "bmp180.h"
+
+#define UT_STEP_OSS0    61
+#define UP_STEP         61
+#define BATCH           64u
+#define CALIBRATIONS    8u
+#define BENCH_CALLS     2000000u
+
+// Datenblattbeispiel und ein echter Sensor, die weiteren Saetze um diese herum gestreut
+static const int16 calibration[2][11] =
+{
+    { 408, -72, -14383, (int16)32741, (int16)32757, (int16)23153, 6190, 4, -32768, -8711, 2868 },
+    { 7911, -934, -14306, (int16)31567, (int16)25671, (int16)18974, 5498, 46, -32768, -11075, 2432 },
+};
+
+static uint32 seed = 12345u;
+
+static int32 Random(int32 range)
+{
+    seed = seed * 1103515245u + 12345u;
+    return (int32)((seed >> 8) % (uint32)(2 * range + 1)) - range;
+}
+
+// um bis zu 1/16 verschieben
+static int32 Jitter(int32 value)
+{
+    return value + Random(((value < 0) ? -value : value) / 16);
+}
+
+static void SetCalibration(uint32 n)
+{
+    const int16 *c = calibration[n & 1u];
+
+    AC1 = c[0]; AC2 = c[1]; AC3 = c[2];
+    AC4 = (uint16)c[3]; AC5 = (uint16)c[4]; AC6 = (uint16)c[5];
+    B1 = c[6]; B2 = c[7]; MB = c[8]; MC = c[9]; MD = c[10];
+    if (n >= 2u)
+    {
+        AC1 = (int16)Jitter(AC1); AC2 = (int16)Jitter(AC2); AC3 = (int16)Jitter(AC3);
+        AC4 = (uint16)Jitter(AC4); AC5 = (uint16)Jitter(AC5); AC6 = (uint16)Jitter(AC6);
+        B1 = (int16)Jitter(B1); MC = (int16)Jitter(MC); MD = (int16)Jitter(MD);
+    }
+}
+
+// Bereich -40..85 C; liegt bei allen Saetzen in AC6 -6000..+9000
+static uint8 InRange(int32 ut, int32 *B5)
+{
+    // Nenner X1 + MD, dort teilen beide Varianten durch 0
+    if ((ut > 32767) || ((((ut - (int32)AC6) * (int32)AC5) >> 15) + MD == 0))
+    {
+        return 0;
+    }
+    (void)BMP180_CalculateTemperature((int16)ut, B5);
+    // ausserhalb laufen schon die Datenblattformeln ueber
+    return (BMP180_TemperatureX10(*B5) >= -400) && (BMP180_TemperatureX10(*B5) <= 850);
+}
+
+static uint64 CompareB5(void)
+{
+    uint64 cases = 0;
+    int32 ut;
+    int32 B5;
+
+    BMP180_PrepareCoeffs();
+    for (ut = (int32)AC6 - 6000; ut <= (int32)AC6 + 9000; ut++)
+    {
+        if (!InRange(ut, &B5))
+        {
+            continue;
+        }
+        CHECK(BMP180_CalculateB5Fast((int16)ut) == B5);
+        cases++;
+    }
+    return cases;
+}
+
+static int16 utBatch[BATCH];
+static int32 upBatch[BATCH];
+static int32 tBatch[BATCH];
+static int32 pBatch[BATCH];
+static int32 pReference[BATCH];
+
+// alle Eintraege eines Batches gegen die Datenblattformeln, gibt Abweichungen zurueck
+static uint32 CompareBatch(int32 B5, uint32 n)
+{
+    uint32 wrong = 0;
+    uint32 i;
+
+    BMP180_CompensateBatch(utBatch, upBatch, tBatch, pBatch, n);
+    for (i = 0; i < n; i++)
+    {
+        if ((pBatch[i] != pReference[i]) || (tBatch[i] != BMP180_TemperatureX10(B5)))
+        {
+            if (wrong++ == 0)
+            {
+                printf("  UT %d UP %ld: %ld/%ld != %ld/%ld\n", utBatch[i], (long)upBatch[i], (long)tBatch[i],
+                       (long)pBatch[i], (long)BMP180_TemperatureX10(B5), (long)pReference[i]);
+            }
+        }
+    }
+    return wrong;
+}
+
+static uint64 Compare(uint8 oss)
+{
+    int32 utStep = (oss == 0) ? UT_STEP_OSS0 : 1;
+    int32 upStep = (oss == 0) ? 1 : (UP_STEP << oss);
+    uint64 cases = 0;
+    uint32 wrong = 0;
+    int32 ut;
+    int32 up;
+
+    BMP180_SetOss(oss);
+    for (ut = (int32)AC6 - 6000; ut <= (int32)AC6 + 9000; ut += utStep)
+    {
+        int32 B5;
+        uint32 n = 0;
+
+        if (!InRange(ut, &B5))
+        {
+            continue;
+        }
+        // 300..1100 hPa liegen bei allen Saetzen in UP 12000..60000 (OSS 0)
+        for (up = 12000 << oss; up <= (60000 << oss); up += upStep)
+        {
+            utBatch[n] = (int16)ut;
+            upBatch[n] = up;
+            pReference[n] = BMP180_CalculatePressure(up, B5);
+            if (++n == BATCH)
+            {
+                wrong += CompareBatch(B5, n);
+                n = 0;
+            }
+            cases++;
+        }
+        wrong += CompareBatch(B5, n);
+    }
+    CHECK(wrong == 0);
+    return cases;
+}
+
+static void Bench(void)
+{
+    volatile int32 sink = 0;
+    uint32 i;
+    int32 B5;
+    double start;
+    double reference;
+    double fast;
+    double batch;
+
+    SetCalibration(1u);
+    BMP180_SetOss(0);
+    start = TestNowNs();
+    for (i = 0; i < BENCH_CALLS; i++)
+    {
+        (void)BMP180_CalculateTemperature((int16)(24000 + (i & 1023u)), &B5);
+        sink += BMP180_CalculatePressure(30000 + (int32)(i & 4095u), B5);
+    }
+    reference = (TestNowNs() - start) / BENCH_CALLS;
+    start = TestNowNs();
+    for (i = 0; i < BENCH_CALLS; i++)
+    {
+        B5 = BMP180_CalculateB5Fast((int16)(24000 + (i & 1023u)));
+        sink += BMP180_CalculatePressure(30000 + (int32)(i & 4095u), B5);
+    }
+    fast = (TestNowNs() - start) / BENCH_CALLS;
+    for (i = 0; i < BATCH; i++)
+    {
+        utBatch[i] = (int16)(24000 + (i & 1023u));
+        upBatch[i] = 30000 + (int32)i;
+    }
+    start = TestNowNs();
+    for (i = 0; i < BENCH_CALLS / BATCH; i++)
+    {
+        BMP180_CompensateBatch(utBatch, upBatch, tBatch, pBatch, BATCH);
+        sink += pBatch[i % BATCH];
+    }
+    batch = (TestNowNs() - start) / BENCH_CALLS;
+    (void)sink;
+    printf("reference %.1f ns, integer B5 %.1f ns, batch %.1f ns per sample\n", reference, fast, batch);
+}
+
+int main(void)
+{
+    uint64 cases = 0;
+    uint32 n;
+    uint8 oss;
+
+    for (n = 0; n < CALIBRATIONS; n++)
+    {
+        SetCalibration(n);
+        cases += CompareB5();
+        for (oss = 0; oss <= BMP180_OSS_MAX; oss++)
+        {
+            cases += Compare(oss);
+        }
+    }
+    printf("%llu cases compared\n", (unsigned long long)cases);
+    Bench();
+    return TestResult("test_bmp180");
+}
@@ -0,0 +1,128 @@
+// Mux Verwaltung in bus.c gegen die nachgebildeten TCA9548A (hal_sim.c):
+// jeder Zugriff erreicht genau den Sensor seines Pfads, umgeschaltet wird nur
+// bei einem Pfadwechsel, der andere Mux wird dabei geschlossen, und
+// Bus_channelStats zaehlt Transaktionen, Bytes, Zeit und Umschaltungen je Kanal.
+
+#include "test.h"
+#include "bmp180.h"
+#include "bus.h"
+#include "hal.h"
+#include "perf.h"
+
+#define REG_ID      0xD0u
+#define CHIP_ID     0x55u
+
+static uint8 ReadId(const Bus_Device *device)
+{
+    uint8 id = 0;
+    CHECK(Bus_DevReadReg(device, REG_ID, &id, 1) == BUS_OK);
+    return id;
+}
+
+// Zugriffe je Pfad zuruecksetzen, damit jeder Abschnitt fuer sich zaehlt
+static void ResetSim(void)
+{
+    uint8 i;
+
+    for (i = 0; i <= HAL_SIM_DIRECT; i++)
+    {
+        Hal_simAccesses[i] = 0;
+    }
+    Hal_simMuxWrites = 0;
+    Hal_simConflicts = 0;
+}
+
+int main(void)
+{
+    Bus_Device a;
+    Bus_Device b;
+    Bus_Device c;
+    uint8 mux0;
+    uint8 mux1;
+    uint8 i;
+    uint32 writes;
+    Bus_ChannelStats *stats;
+
+    Perf_Init();
+    Hal_simDirect = 0;
+    Bus_Init();
+    ResetSim();
+
+    // beim Anmelden wird jeder Mux einmal geschlossen
+    mux0 = Bus_AddMux(BUS_MUX_ADDR);
+    mux1 = Bus_AddMux(BUS_MUX_ADDR + 1u);
+    CHECK((mux0 == 0) && (mux1 == 1));
+    CHECK(Bus_AddMux(BUS_MUX_ADDR + 2u) == BUS_NO_MUX);
+    CHECK(Bus_MuxCount() == 2u);
+    CHECK(Hal_simMuxWrites == 2u);
+    CHECK((Hal_simMux[0] == 0) && (Hal_simMux[1] == 0));
+
+    Bus_Bind(&a, BMP180_ADDR, mux0, 1);
+    Bus_Bind(&b, BMP180_ADDR, mux0, 6);
+    Bus_Bind(&c, BMP180_ADDR, mux1, 3);
+
+    // gleicher Pfad: nur das erste Mal umschalten
+    ResetSim();
+    for (i = 0; i < 10u; i++)
+    {
+        CHECK(ReadId(&a) == CHIP_ID);
+    }
+    CHECK(Hal_simMuxWrites == 1u);
+    CHECK(Hal_simMux[0] == (1u << 1));
+    // Registeradresse schreiben und lesen: zwei Transfers je Zugriff
+    CHECK(Hal_simAccesses[1] == 20u);
+    stats = &Bus_channelStats[mux0][1];
+    CHECK(stats->selects == 1u);
+    CHECK(stats->transactions == 10u);
+    CHECK(stats->bytes == 20u);
+    // mindestens die simulierte Buszeit: 2 + 2 Bytes mit Adressbyte je Zugriff
+    CHECK(stats->cycles >= 10u * Perf_UsToCycles(4u * 90u));
+
+    // abwechselnd gegen sortiert auf demselben Mux, a ist noch offen
+    ResetSim();
+    for (i = 0; i < 8u; i++)
+    {
+        ReadId((i & 1u) ? &b : &a);
+    }
+    writes = Hal_simMuxWrites;
+    CHECK(writes == 7u);
+    ResetSim();
+    for (i = 0; i < 8u; i++)
+    {
+        ReadId((i < 4u) ? &a : &b);
+    }
+    CHECK(Hal_simMuxWrites == 2u);
+    CHECK((Hal_simAccesses[1] == 8u) && (Hal_simAccesses[6] == 8u));
+    CHECK(Bus_PathKey(&a) < Bus_PathKey(&b));
+
+    // anderer Mux: der bisherige wird geschlossen, nie zwei Pfade offen
+    ResetSim();
+    CHECK(ReadId(&c) == CHIP_ID);
+    CHECK(Hal_simMuxWrites == 2u);
+    CHECK((Hal_simMux[0] == 0) && (Hal_simMux[1] == (1u << 3)));
+    CHECK(Hal_simAccesses[BUS_MUX_CHANNELS + 3u] == 2u);
+    CHECK(ReadId(&a) == CHIP_ID);
+    CHECK((Hal_simMux[0] == (1u << 1)) && (Hal_simMux[1] == 0));
+    CHECK(Hal_simConflicts == 0);
+    CHECK(Bus_channelStats[mux1][3].selects == 1u);
+    CHECK(Bus_channelStats[mux1][3].transactions == 1u);
+    CHECK(Bus_channelStats[mux0][3].transactions == 0);
+
+    // der ganze Treiber hinter einem Mux
+    Bus_Bind(&BMP180_device, BMP180_ADDR, mux1, 3);
+    BMP180_Init();
+    CHECK(BMP180_errors == 0);
+    CHECK((AC1 == 408) && (AC4 == 32741u) && (MD == 2868));
+
+    // Sensor direkt am Bus und offener Kanal: Adresskonflikt, keiner antwortet
+    Hal_simDirect = 1;
+    ResetSim();
+    {
+        uint8 id;
+        CHECK(Bus_DevReadReg(&c, REG_ID, &id, 1) == BUS_ERR_NAK);
+    }
+    CHECK(Hal_simConflicts > 0);
+    CHECK(Bus_stats.naks > 0);
+
+    return TestResult("test_bus");
+}
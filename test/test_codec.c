@@ -0,0 +1,334 @@
+// Codec Rahmen: ein sauberer Strom kommt vollstaendig an, Text zwischen den
+// Bloecken stoert nicht, und bei fehlenden oder verfaelschten Bytes und bei
+// 0xA5 in den Daten liefert der Decoder nie einen falschen Datensatz, sondern
+// verwirft hoechstens die betroffenen Bloecke.
+//
+// Kompression auf einer Aufzeichnung mit dem nachgebildeten BMP180 (hal_sim.c)
+// bei OSS 0 im Takt des Sensors: Telemetrie wie ProcessSample() in main.c
+// (Filter und Dezimierung der Vorgabe, Zeit in ms) und Rohwert Log wie log.c,
+// gemessen gegen 4 Bytes je Wert.
+
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "project.h"
+#include "bmp180.h"
+#include "bus.h"
+#include "codec.h"
+#include "filter.h"
+#include "hal.h"
+#include "log.h"
+#include "perf.h"
+#include "timebase.h"
+
+#define RECORDS     1000u
+#define CHANNELS    3u
+#define KEY         16u
+#define ORDER2      0x04u       // Zeit wie in main.c
+#define STREAM_MAX  (RECORDS * CODEC_MAX_RECORD + 200u * 8u)
+
+static int32 expected[RECORDS][CHANNELS];
+static uint8 stream[STREAM_MAX];
+static uint32 streamLength;
+static uint32 texts;
+static uint8 seen[RECORDS];
+
+typedef struct
+{
+    uint32 delivered;
+    uint32 wrong;
+} Result;
+
+static void Record(void *context, uint32_t seq, const int32_t *values)
+{
+    Result *result = context;
+    uint8 i;
+
+    result->delivered++;
+    if (seq >= RECORDS)
+    {
+        result->wrong++;
+        return;
+    }
+    for (i = 0; i < CHANNELS; i++)
+    {
+        if (values[i] != expected[seq][i])
+        {
+            result->wrong++;
+            return;
+        }
+    }
+    seen[seq] = 1;
+}
+
+// wie main.c: Druck, Temperatur, Zeit in ms. wild: grosse Spruenge, damit
+// viele Bytes 0xA5 und 0x80 in den Daten stehen
+static void MakeValues(uint8 wild)
+{
+    uint32 i;
+    int32 p = 100000;
+    int32 t = 215;
+
+    srand(1);
+    for (i = 0; i < RECORDS; i++)
+    {
+        p += wild ? (rand() % 2000001) - 1000000 : (rand() % 11) - 5;
+        t += wild ? (rand() % 20001) - 10000 : (rand() % 3) - 1;
+        expected[i][0] = p;
+        expected[i][1] = t;
+        expected[i][2] = (int32)(i * 100u);
+    }
+}
+
+// ab und zu wird ein Block fuer eine Textantwort geschlossen, wie vor Cmd_Handle()
+static void Encode(Codec_Encoder *enc)
+{
+    uint32 i;
+
+    Codec_InitEncoder(enc, CHANNELS, KEY, ORDER2);
+    streamLength = 0;
+    texts = 0;
+    for (i = 0; i < RECORDS; i++)
+    {
+        streamLength += Codec_Encode(enc, expected[i], &stream[streamLength]);
+        if ((i % 97u) == 50u)
+        {
+            streamLength += Codec_Flush(enc, &stream[streamLength]);
+            memcpy(&stream[streamLength], "OK\r\nT 123 456\r\n", 15);
+            streamLength += 15u;
+            texts++;
+        }
+    }
+    streamLength += Codec_Flush(enc, &stream[streamLength]);
+}
+
+// Strom dekodieren, dabei Byte skip auslassen und Byte flip mit mask verknuepfen
+static Result Decode(const uint8 *data, uint32 length, uint32 skip, uint32 flip, uint8 mask, Codec_Decoder *dec)
+{
+    Result result = { 0, 0 };
+    uint32 i;
+
+    memset(seen, 0, sizeof(seen));
+    Codec_InitDecoder(dec, CHANNELS, KEY, ORDER2, Record, &result);
+    for (i = 0; i < length; i++)
+    {
+        if (i != skip)
+        {
+            Codec_Decode(dec, (i == flip) ? (uint8)(data[i] ^ mask) : data[i]);
+        }
+    }
+    return result;
+}
+
+static uint32 Missing(void)
+{
+    uint32 i;
+    uint32 n = 0;
+
+    for (i = 0; i < RECORDS; i++)
+    {
+        n += !seen[i];
+    }
+    return n;
+}
+
+static Codec_Encoder enc;
+static Codec_Decoder dec;
+
+#define CAPTURE_SAMPLES     4096u
+#define DECIMATION          8u          // wie OUTPUT_DECIMATION in main.c
+#define TELEMETRY_KEY       KEY         // wie TELEMETRY_KEY_INTERVAL/TELEMETRY_ORDER2 in main.c
+#define TELEMETRY_ORDER2    ORDER2
+#define RAW_BYTES           4u          // ein Wert als int32
+
+static uint8 telemetry[CAPTURE_SAMPLES / DECIMATION * CODEC_MAX_RECORD];
+static uint8 logStream[CAPTURE_SAMPLES * CODEC_MAX_RECORD];
+static uint32 telemetryLength;
+static uint32 logLength;
+static Codec_Encoder logEnc;
+
+static void Count(void *context, uint32_t seq, const int32_t *values)
+{
+    (void)seq;
+    (void)values;
+    (*(uint32 *)context)++;
+}
+
+// Kompression in Prozent der Rohgroesse
+static uint32 Percent(const Codec_Encoder *encoder)
+{
+    return Codec_BytesPerRecordX100(encoder) / (encoder->channels * RAW_BYTES);
+}
+
+static void Capture(void)
+{
+    Filter_Chain pressureFilter;
+    Filter_Chain tempFilter;
+    uint32 i;
+    uint32 decoded = 0;
+    uint32 records = 0;
+
+    Perf_Init();
+    Bus_Init();
+    BMP180_Init();
+    BMP180_SetOss(0);
+    Filter_Init(&pressureFilter, DECIMATION);
+    Filter_AddStage(&pressureFilter, FILTER_MEDIAN, 5);
+    Filter_AddStage(&pressureFilter, FILTER_IIR, 2);
+    Filter_Init(&tempFilter, DECIMATION);
+    Filter_AddStage(&tempFilter, FILTER_BOXCAR, 8);
+    Codec_InitEncoder(&enc, CHANNELS, TELEMETRY_KEY, TELEMETRY_ORDER2);
+    Codec_InitEncoder(&logEnc, LOG_CHANNELS, LOG_KEY_INTERVAL, 0);
+    telemetryLength = 0;
+    logLength = 0;
+
+    for (i = 0; i < CAPTURE_SAMPLES; i++)
+    {
+        uint64 t = Time_Us();
+        int32_t raw[LOG_CHANNELS];
+        int32 B5;
+        int32 pressure;
+        int32 temp;
+
+        BMP180_StartTemperature();
+        Hal_DelayMs(BMP180_TEMP_CONV_MS);
+        while (!BMP180_ConversionDone())
+        {
+        }
+        raw[0] = (int16)BMP180_ReadResult();
+        BMP180_StartPressure();
+        Hal_DelayMs(BMP180_PressureConvMs());
+        while (!BMP180_ConversionDone())
+        {
+        }
+        raw[1] = BMP180_ReadPressureResult();
+        logLength += Codec_Encode(&logEnc, raw, &logStream[logLength]);
+
+        B5 = BMP180_CalculateB5Fast((int16)raw[0]);
+        pressure = BMP180_CalculatePressure(raw[1], B5);
+        temp = BMP180_TemperatureX10(B5);
+        Filter_Process(&tempFilter, temp, &temp);
+        if (Filter_Process(&pressureFilter, pressure, &pressure))
+        {
+            expected[records][0] = pressure;
+            expected[records][1] = temp;
+            expected[records][2] = (int32)(uint32)(t / 1000u);
+            telemetryLength += Codec_Encode(&enc, expected[records], &telemetry[telemetryLength]);
+            records++;
+        }
+    }
+    telemetryLength += Codec_Flush(&enc, &telemetry[telemetryLength]);
+    logLength += Codec_Flush(&logEnc, &logStream[logLength]);
+    CHECK(BMP180_errors == 0);
+
+    // beide Stroeme kommen vollstaendig und richtig an
+    CHECK(records == CAPTURE_SAMPLES / DECIMATION);
+    CHECK(Decode(telemetry, telemetryLength, ~0u, ~0u, 0, &dec).wrong == 0);
+    CHECK(Missing() == RECORDS - records);
+    Codec_InitDecoder(&dec, LOG_CHANNELS, LOG_KEY_INTERVAL, 0, Count, &decoded);
+    for (i = 0; i < logLength; i++)
+    {
+        Codec_Decode(&dec, logStream[i]);
+    }
+    CHECK(decoded == CAPTURE_SAMPLES);
+
+    printf("capture: %lu S/s, telemetry %lu.%02lu B/record (%lu %% of raw), log %lu.%02lu B/record (%lu %% of raw)\n",
+           (unsigned long)(CAPTURE_SAMPLES * 1000000ull / Time_Us()),
+           (unsigned long)(Codec_BytesPerRecordX100(&enc) / 100u), (unsigned long)(Codec_BytesPerRecordX100(&enc) % 100u),
+           (unsigned long)Percent(&enc),
+           (unsigned long)(Codec_BytesPerRecordX100(&logEnc) / 100u),
+           (unsigned long)(Codec_BytesPerRecordX100(&logEnc) % 100u), (unsigned long)Percent(&logEnc));
+}
+
+static void Damage(const char *name)
+{
+    uint32 pos;
+    uint32 worst = 0;
+    uint32 wrong = 0;
+    Result result;
+
+    // jede Position einmal entfernt bzw. mit einem anderen Bit gekippt
+    for (pos = 0; pos < streamLength; pos += 3u)
+    {
+        result = Decode(stream, streamLength, pos, ~0u, 0, &dec);
+        wrong += result.wrong;
+        worst = (Missing() > worst) ? Missing() : worst;
+        CHECK(result.delivered + Missing() == RECORDS);
+
+        result = Decode(stream, streamLength, ~0u, pos, (uint8)(1u << (pos % 8u)), &dec);
+        wrong += result.wrong;
+        worst = (Missing() > worst) ? Missing() : worst;
+    }
+    // ein Fehler kostet hoechstens zwei Bloecke (der Fehlerblock und ggf. der
+    // dahinter, wenn das Blockende getroffen wurde)
+    CHECK(wrong == 0);
+    CHECK(worst <= 2u * KEY);
+    printf("%s: %lu bytes, %lu per error lost at most\n", name, (unsigned long)streamLength, (unsigned long)worst);
+}
+
+int main(void)
+{
+    Result result;
+    uint32 i;
+    uint32 sync = 0;
+    static uint8 noisy[STREAM_MAX + 64u];
+    uint32 n = 0;
+
+    // sauberer Strom mit Text dazwischen
+    MakeValues(0);
+    Encode(&enc);
+    result = Decode(stream, streamLength, ~0u, ~0u, 0, &dec);
+    CHECK(result.wrong == 0);
+    CHECK(result.delivered == RECORDS);
+    CHECK(dec.rejected == 0);
+    CHECK(dec.skipped == texts * 15u);
+    printf("telemetry: %lu.%02lu bytes/record\n", (unsigned long)(Codec_BytesPerRecordX100(&enc) / 100u),
+           (unsigned long)(Codec_BytesPerRecordX100(&enc) % 100u));
+    CHECK(Codec_BytesPerRecordX100(&enc) < 700u);
+    Damage("lost/flipped byte");
+
+    // Muell mit Sync Bytes vor dem Strom und abgebrochener Block mitten drin
+    memset(noisy, CODEC_SYNC, 16);
+    n = 16;
+    noisy[n++] = 0x80;
+    noisy[n++] = 0x00;
+    memcpy(&noisy[n], stream, 40);
+    n += 40u;
+    memcpy(&noisy[n], stream, streamLength);
+    n += streamLength;
+    result = Decode(noisy, n, ~0u, ~0u, 0, &dec);
+    CHECK(result.wrong == 0);
+    CHECK(Missing() == 0);
+
+    // Codec_ForceKeyframe(): abgebrochener Block wird verworfen, der naechste kommt an
+    Codec_InitEncoder(&enc, CHANNELS, KEY, ORDER2);
+    n = Codec_Encode(&enc, expected[0], noisy);
+    n += Codec_Encode(&enc, expected[1], &noisy[n]);
+    Codec_ForceKeyframe(&enc);
+    enc.seq = 2;
+    n += Codec_Encode(&enc, expected[2], &noisy[n]);
+    n += Codec_Flush(&enc, &noisy[n]);
+    result = Decode(noisy, n, ~0u, ~0u, 0, &dec);
+    CHECK(result.wrong == 0);
+    CHECK((result.delivered == 1u) && seen[2]);
+
+    // Aufzeichnung: mindestens 3x kleiner als 4 Bytes je Wert
+    Capture();
+    CHECK(Percent(&enc) <= 33u);
+    CHECK(Percent(&logEnc) <= 33u);
+
+    // grosse Spruenge: 0xA5 in den Daten
+    MakeValues(1);
+    Encode(&enc);
+    for (i = 0; i < streamLength; i++)
+    {
+        sync += (stream[i] == CODEC_SYNC);
+    }
+    result = Decode(stream, streamLength, ~0u, ~0u, 0, &dec);
+    CHECK(result.wrong == 0);
+    CHECK(result.delivered == RECORDS);
+    CHECK(sync > dec.blocks + 10u);
+    Damage("0xA5 in data");
+
+    return TestResult("test_codec");
+}
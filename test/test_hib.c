@@ -0,0 +1,73 @@
+// Schlafen zwischen langen Messabstaenden (hib.c) gegen den nachgebildeten
+// CTW (host/host.c): die mit Time_Advance() nachgetragene Zeit muss der echt
+// verschlafenen entsprechen, auch wenn der CTW vor dem Schlaf schon mitten in
+// einem Intervall steht, und aufgewacht wird vor dem Termin.
+
+#include "test.h"
+#include "hib.h"
+#include "out.h"
+#include "perf.h"
+#include "timebase.h"
+
+#define PERIOD_US       HIB_MIN_PERIOD_US
+#define SLEEPS          6u
+#define POLL_US         10u
+
+int main(void)
+{
+    uint64 deadline;
+    int64 drift;
+    uint8 k;
+
+    Perf_Init();
+    Out_Init();
+    Hib_Init();
+
+    // Wachzeit nach der Messung je Runde anders, damit der CTW bei jedem
+    // Schlaf an einer anderen Stelle seines Intervalls steht
+    deadline = Time_Us() + PERIOD_US;
+    for (k = 0; k < SLEEPS; k++)
+    {
+        uint32 sleeps = Hib_stats.sleeps;
+        uint32 intervals = Hib_stats.intervals;
+        uint64 time;
+        uint64 real;
+        int64 error;
+        Acq_Sample sample;
+
+        do
+        {
+            time = Time_Us();
+            real = Host_RealUs();
+            Hib_Idle(deadline);
+            CyDelayUs(POLL_US);
+        } while ((Hib_stats.sleeps == sleeps) && (Time_Us() < deadline));
+        CHECK(Hib_stats.sleeps == sleeps + 1u);
+
+        // Kalibrierung auf POLL_US genau, je Intervall hoechstens so viel
+        error = (int64)(Time_Us() - time) - (int64)(Host_RealUs() - real);
+        if (error < 0)
+        {
+            error = -error;
+        }
+        CHECK(error <= (int64)((Hib_stats.intervals - intervals) * 2u * POLL_US + 1000u));
+        CHECK(Time_Us() < deadline);
+        CHECK(deadline - Time_Us() <= (uint64)HIB_WAKE_LEAD_MS * 1000u + Hib_stats.ctwUs);
+
+        while (Time_Us() < deadline)
+        {
+            CyDelayUs(POLL_US);
+        }
+        CyDelay(100u + 137u * k);
+        sample.tEnd = Time_Us();
+        Hib_SampleDone(&sample);
+        deadline += PERIOD_US;
+    }
+    // die Zeitbasis weicht ueber alle Schlafphasen nicht von der echten ab
+    drift = (int64)(Time_Us() - Host_RealUs());
+    CHECK((drift <= (int64)(SLEEPS * 1000u)) && (drift >= -(int64)(SLEEPS * 1000u)));
+    printf("hib: ctw %lu us, %lu intervals, drift %lld us\n", (unsigned long)Hib_stats.ctwUs,
+           (unsigned long)Hib_stats.intervals, (long long)drift);
+
+    return TestResult("test_hib");
+}
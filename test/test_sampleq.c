@@ -0,0 +1,127 @@
+// SampleQ mit echtem Producer und Consumer in zwei Threads: jeder Datensatz
+// kommt vollstaendig und in Reihenfolge an, Verluste stehen genau in drops,
+// highWater bleibt im Ring. Der Consumer legt ab und zu Pausen ein, damit der
+// Ring auch voll wird. Laeuft auch auf einem Kern, dann unterbricht der
+// Scheduler die Threads an beliebigen Stellen.
+
+#include <pthread.h>
+#include <sched.h>
+#include "test.h"
+#include "sampleq.h"
+
+#define ITEMS   5000000u
+
+static volatile uint32 spin;
+
+static void Spin(uint32 n)
+{
+    while (n--)
+    {
+        spin++;
+    }
+}
+
+static SampleQ queue;
+static volatile uint8 producerDone;
+static uint32 pushed;
+
+static void Fill(Acq_Sample *sample, uint32 seq)
+{
+    sample->seq = seq;
+    sample->ut = (int16)(seq * 7u);
+    sample->up = (int32)~seq;
+    sample->tStart = (uint64)seq * 3u;
+    sample->tEnd = ((uint64)seq << 32) | seq;
+    sample->errors = (uint8)seq;
+}
+
+static void *Producer(void *arg)
+{
+    Acq_Sample sample;
+    uint32 seq;
+
+    (void)arg;
+    for (seq = 0; seq < ITEMS; seq++)
+    {
+        Fill(&sample, seq);
+        if (SampleQ_Push(&queue, &sample))
+        {
+            pushed++;
+        }
+        else
+        {
+            // verworfen; Platz machen, auch wenn beide Threads auf einem Kern laufen
+            sched_yield();
+        }
+        Spin(seq & 15u);
+    }
+    producerDone = 1;
+    return NULL;
+}
+
+static void *Consumer(void *arg)
+{
+    Acq_Sample sample;
+    Acq_Sample expect;
+    uint32 popped = 0;
+    uint32 torn = 0;
+    uint32 order = 0;
+    uint32 last = 0;
+    uint32 pause = 1;
+
+    (void)arg;
+    for (;;)
+    {
+        if (!SampleQ_Pop(&queue, &sample))
+        {
+            if (producerDone && (SampleQ_Count(&queue) == 0))
+            {
+                break;
+            }
+            sched_yield();
+            continue;
+        }
+        Fill(&expect, sample.seq);
+        if ((sample.ut != expect.ut) || (sample.up != expect.up) || (sample.tStart != expect.tStart) ||
+            (sample.tEnd != expect.tEnd) || (sample.errors != expect.errors))
+        {
+            torn++;
+        }
+        if ((popped > 0) && (sample.seq <= last))
+        {
+            order++;
+        }
+        last = sample.seq;
+        popped++;
+        // gelegentlich langsam, damit der Producer auf einen vollen Ring trifft
+        pause = pause * 1103515245u + 12345u;
+        if ((pause >> 20) % 4096u == 0)
+        {
+            Spin(20000u);
+        }
+    }
+    CHECK(torn == 0);
+    CHECK(order == 0);
+    *(uint32 *)arg = popped;
+    return NULL;
+}
+
+int main(void)
+{
+    pthread_t producer;
+    pthread_t consumer;
+    uint32 popped = 0;
+
+    SampleQ_Init(&queue);
+    pthread_create(&consumer, NULL, Consumer, &popped);
+    pthread_create(&producer, NULL, Producer, NULL);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+
+    printf("pushed %u, popped %u, drops %u, high water %u\n", pushed, popped, queue.drops, queue.highWater);
+    CHECK(popped == pushed);
+    CHECK(pushed + queue.drops == ITEMS);
+    CHECK(queue.highWater <= SAMPLEQ_SIZE);
+    CHECK(queue.drops > 0);
+    return TestResult("test_sampleq");
+}
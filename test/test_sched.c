@@ -0,0 +1,202 @@
+// Scheduler (sched.c) gegen nachgebildete BMP180 hinter einem TCA9548A
+// (hal_sim.c): jedes Geraet durchlaeuft seine Phasen in Reihenfolge, keine
+// Phase kommt vor dem Ende ihrer Wandlung (kein Ergebnis wird zu frueh
+// gelesen), verschachtelt ist schneller als nacheinander, und die Zeiten von
+// Sched_simBmp180 passen zum nachgebildeten Sensor.
+
+#include "test.h"
+#include "bmp180.h"
+#include "bus.h"
+#include "hal.h"
+#include "perf.h"
+#include "sched.h"
+
+#define DEVICES     4u
+#define ROUNDS      8u
+#define SIM_UT      27898       // wie hal_sim.c
+#define SIM_UP      23843
+#define CONV_US     4500u       // Temperatur und Druck bei OSS 0
+
+typedef struct
+{
+    Bus_Device bus;
+    uint8 lastPhase;
+    uint32 lastEnd;             // Perf_Cycles() am Ende der letzten Phase
+    uint32 convUs;              // Wandlungszeit, die die letzte Phase gestartet hat
+    uint32 order;               // Phasen ausser der Reihe
+    uint32 early;               // Phasen vor Ende der Wandlung
+    uint32 wrong;               // Rohwerte nicht vom Sensor
+    int32 ut;
+} Sensor;
+
+static Sensor sensors[DEVICES];
+
+static uint8 Start(const Bus_Device *bus, uint8 cmd)
+{
+    uint8 data[2] = { BMP180_REG_CTRL, cmd };
+    return Bus_DevWrite(bus, data, 2);
+}
+
+static int32 Result(const Bus_Device *bus)
+{
+    uint8 data[2] = { 0, 0 };
+    (void)Bus_DevReadReg(bus, BMP180_REG_RESULT, data, 2);
+    return ((int32)data[0] << 8) | data[1];
+}
+
+static uint8 Near(int32 value, int32 expected)
+{
+    return (value >= expected - 2) && (value <= expected + 2);
+}
+
+// Temperatur starten, UT lesen + Druck starten, UP lesen
+static uint32 Step(Sched_Device *device, uint8 phase)
+{
+    Sensor *sensor = (Sensor *)device->context;
+    uint32 start = Perf_Cycles();
+    uint32 wait = 0;
+
+    if ((phase == 0) ? (sensor->lastPhase != 0xFFu) : (phase != sensor->lastPhase + 1u))
+    {
+        sensor->order++;
+    }
+    if ((phase > 0) && ((start - sensor->lastEnd) < Perf_UsToCycles(sensor->convUs)))
+    {
+        sensor->early++;
+    }
+
+    switch (phase)
+    {
+    case 0:
+        (void)Start(&sensor->bus, BMP180_CMD_TEMP);
+        wait = CONV_US;
+        break;
+    case 1:
+        sensor->ut = Result(&sensor->bus);
+        (void)Start(&sensor->bus, BMP180_CMD_PRES_OSS(0u));
+        wait = CONV_US;
+        break;
+    default:
+        if (!Near(sensor->ut, SIM_UT) || !Near(Result(&sensor->bus), SIM_UP))
+        {
+            sensor->wrong++;
+        }
+        break;
+    }
+    sensor->lastPhase = (wait == 0) ? 0xFFu : phase;
+    sensor->convUs = wait;
+    sensor->lastEnd = Perf_Cycles();
+    return wait;
+}
+
+static void Setup(Sched *sched, Sched_Device *devices, uint8 mux)
+{
+    uint8 i;
+
+    Sched_Init(sched, NULL);
+    for (i = 0; i < DEVICES; i++)
+    {
+        // rueckwaerts anmelden, einsortiert wird nach Kanal
+        Sensor *sensor = &sensors[DEVICES - 1u - i];
+        Bus_Bind(&sensor->bus, BMP180_ADDR, mux, (uint8)(DEVICES - 1u - i));
+        sensor->lastPhase = 0xFFu;
+        devices[i].step = Step;
+        devices[i].path = &sensor->bus;
+        devices[i].context = sensor;
+        CHECK(Sched_Add(sched, &devices[i]));
+    }
+    for (i = 1; i < DEVICES; i++)
+    {
+        CHECK(Bus_PathKey(sched->device[i - 1u]->path) < Bus_PathKey(sched->device[i]->path));
+    }
+}
+
+static void CheckSensors(const char *name)
+{
+    uint8 i;
+
+    for (i = 0; i < DEVICES; i++)
+    {
+        CHECK(sensors[i].order == 0);
+        CHECK(sensors[i].early == 0);
+        CHECK(sensors[i].wrong == 0);
+        CHECK(sensors[i].lastPhase == 0xFFu);
+    }
+    CHECK(Hal_simEarlyReads == 0);
+    CHECK(Hal_simConflicts == 0);
+    (void)name;
+}
+
+int main(void)
+{
+    static Sched sched;
+    static Sched_Device devices[DEVICES];
+    uint32 sequential;
+    uint32 interleaved;
+    uint32 busTable;
+    uint32 busSim;
+    uint8 mux;
+    uint8 i;
+
+    Perf_Init();
+    Hal_simDirect = 0;
+    Bus_Init();
+    mux = Bus_AddMux(BUS_MUX_ADDR);
+    Setup(&sched, devices, mux);
+
+    for (i = 0; i < ROUNDS; i++)
+    {
+        Sched_RunSequential(&sched);
+    }
+    CheckSensors("sequential");
+    CHECK(sched.stats.samples == DEVICES * ROUNDS);
+    sequential = Sched_SamplesPerSecondX100(&sched);
+
+    Sched_ResetStats(&sched);
+    for (i = 0; i < ROUNDS; i++)
+    {
+        Sched_RunInterleaved(&sched);
+    }
+    CheckSensors("interleaved");
+    CHECK(sched.stats.samples == DEVICES * ROUNDS);
+    interleaved = Sched_SamplesPerSecondX100(&sched);
+    printf("sched: %u sensors, sequential %lu.%02lu S/s, interleaved %lu.%02lu S/s, bus %lu.%lu %%\n", DEVICES,
+           (unsigned long)(sequential / 100u), (unsigned long)(sequential % 100u),
+           (unsigned long)(interleaved / 100u), (unsigned long)(interleaved % 100u),
+           (unsigned long)(Sched_UtilizationX10(&sched) / 10u), (unsigned long)(Sched_UtilizationX10(&sched) % 10u));
+    // die Wandlungen laufen parallel, begrenzt wird durch den Bus samt Mux
+    CHECK(2u * interleaved > 5u * sequential);
+
+    // Sched_simBmp180 gegen den nachgebildeten Sensor: Busbelegung je Messung
+    // ohne Mux (ein Sensor direkt am Bus), auf 3 % wie die Bytezahlen
+    Perf_Init();
+    Hal_simDirect = 1;
+    Bus_Init();
+    Sched_Init(&sched, NULL);
+    sensors[0].lastPhase = 0xFFu;
+    Bus_Bind(&sensors[0].bus, BMP180_ADDR, BUS_NO_MUX, 0);
+    devices[0].step = Step;
+    devices[0].path = NULL;
+    devices[0].context = &sensors[0];
+    Sched_Add(&sched, &devices[0]);
+    for (i = 0; i < ROUNDS; i++)
+    {
+        Sched_RunSequential(&sched);
+    }
+    busSim = Perf_CyclesToUs(sched.stats.busCycles) / ROUNDS;
+
+    Sched_Init(&sched, NULL);
+    devices[0].step = Sched_SimStep;
+    devices[0].context = (void *)&Sched_simBmp180;
+    Sched_Add(&sched, &devices[0]);
+    for (i = 0; i < ROUNDS; i++)
+    {
+        Sched_RunSequential(&sched);
+    }
+    busTable = Perf_CyclesToUs(sched.stats.busCycles) / ROUNDS;
+    printf("sched: bus per sample %lu us simulated sensor, %lu us Sched_simBmp180\n",
+           (unsigned long)busSim, (unsigned long)busTable);
+    CHECK((busTable * 100u >= busSim * 97u) && (busTable * 100u <= busSim * 103u));
+
+    return TestResult("test_sched");
+}
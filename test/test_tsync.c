@@ -0,0 +1,143 @@
+// Zeitabgleich (tsync.c) in der Schleife gegen einen nachgebildeten Host, wie
+// ihn tsync_host an der seriellen Schnittstelle spielt: bekannter Offset und
+// Gang der Geraeteuhr, Laufzeit je Richtung mit Schwankung. Offset, Laufzeit
+// und Drift muessen gegen die vorgegebenen Werte konvergieren, TimeSync_ToHost()
+// am Ende auf die Laufzeitschwankung genau stimmen.
+
+#include <string.h>
+#include "test.h"
+#include "config.h"
+#include "tsync.h"
+#include "out.h"
+#include "perf.h"
+#include "timebase.h"
+
+#define HOST_START_US   1700000000000000ll  // Wanduhr des Hosts bei Geraetezeit 0
+#define DRIFT_PPB       40000               // Geraet geht 40 ppm vor
+#define LINK_US         1500u               // Laufzeit je Richtung
+#define JITTER_US       400u                // plus 0..JITTER_US, je Richtung zufaellig
+#define EXCHANGES       120u
+#define INTERVAL_MS     5000u
+
+static uint32 seed = 1;
+
+static uint32 Jitter(void)
+{
+    seed = seed * 1103515245u + 12345u;
+    return (seed >> 16) % (JITTER_US + 1u);
+}
+
+// Hostzeit zu einer Geraetezeit: Offset (Geraet - Host) waechst mit der Drift
+static int64 Offset(uint64 device)
+{
+    return -HOST_START_US + ((int64)device * DRIFT_PPB) / 1000000000;
+}
+
+static uint64 HostTime(uint64 device)
+{
+    return (uint64)((int64)device - Offset(device));
+}
+
+static void Line(const char *format, uint64 a, uint64 b, char *line)
+{
+    snprintf(line, RX_LINE_MAX, format, (unsigned long long)a, (unsigned long long)b);
+}
+
+// ein Austausch TS1 -> TS -> TS2, gibt 0 zurueck wenn keine Antwort kam
+static uint8 Exchange(uint32 extraDownUs)
+{
+    char line[RX_LINE_MAX];
+    char reply[80];
+    unsigned long long t1;
+    unsigned long long t2;
+    unsigned long long t3;
+    uint64 t4;
+
+    t1 = HostTime(Time_Us());
+    Line("TS1 %llu", t1, 0, line);
+    CyDelayUs((uint16)(LINK_US + Jitter()));
+    CHECK(TimeSync_Handle(line, Time_Us()));
+    CHECK(TimeSync_ReplyPending());
+
+    CyDelayUs(300u);
+    Host_uartLength = 0;
+    TimeSync_Poll();
+    while (Out_Pending() > 0)
+    {
+        Out_Poll();
+    }
+    CHECK(!TimeSync_ReplyPending());
+    if (Host_uartLength >= sizeof(reply))
+    {
+        return 0;
+    }
+    memcpy(reply, Host_uartOut, Host_uartLength);
+    reply[Host_uartLength] = '\0';
+    if ((sscanf(reply, "TS %llu %llu %llu", &t1, &t2, &t3) != 3))
+    {
+        return 0;
+    }
+
+    CyDelayUs((uint16)(LINK_US + Jitter()));
+    CyDelay(extraDownUs / 1000u);
+    t4 = HostTime(Time_Us());
+    Line("TS2 %llu %llu", t1, t4, line);
+    CHECK(TimeSync_Handle(line, Time_Us()));
+    return 1;
+}
+
+int main(void)
+{
+    uint32 i;
+    int64 error;
+    int64 driftError = 0;
+    uint64 now;
+
+    Perf_Init();
+    Out_Init();
+    TimeSync_Init();
+    CHECK(!TimeSync_Valid());
+    CHECK(!TimeSync_Handle("TEMP 1", 0));
+
+    // TS2 zu einem anderen t1 zaehlt nicht
+    CHECK(TimeSync_Handle("TS1 5", Time_Us()));
+    TimeSync_Poll();
+    CHECK(!TimeSync_ReplyPending());
+    CHECK(TimeSync_Handle("TS2 6 100", Time_Us()));
+    CHECK(TimeSync_stats.exchanges == 0);
+    TimeSync_Init();
+
+    for (i = 0; i < EXCHANGES; i++)
+    {
+        CHECK(Exchange(0));
+        error = TimeSync_stats.offsetUs - Offset(Time_Us());
+        // Offset auf die halbe Laufzeitdifferenz genau, Laufzeit auf die Schwankung
+        CHECK((error <= (int64)JITTER_US) && (error >= -(int64)JITTER_US));
+        CHECK((TimeSync_stats.delayUs >= 2u * LINK_US) && (TimeSync_stats.delayUs <= 2u * (LINK_US + JITTER_US)));
+        if ((i + 1u) % 30u == 0)
+        {
+            driftError = (int64)TimeSync_stats.driftPpb - DRIFT_PPB;
+            printf("tsync: %3lu s offset error %lld us, drift error %lld ppb\n",
+                   (unsigned long)(Time_Us() / 1000000u), (long long)error, (long long)driftError);
+        }
+        CyDelay(INTERVAL_MS);
+    }
+    CHECK(TimeSync_Valid());
+    CHECK(TimeSync_stats.exchanges == EXCHANGES);
+    // nach 10 min: Fehler der halben Laufzeitdifferenz verteilt auf die Spanne
+    CHECK((driftError <= 2000) && (driftError >= -2000));
+
+    // Hostzeit fuer einen Zeitstempel eine Weile nach dem letzten Austausch
+    CyDelay(60000u);
+    now = Time_Us();
+    error = (int64)(TimeSync_ToHost(now) - HostTime(now));
+    printf("tsync: ToHost error %lld us 60 s after the last exchange\n", (long long)error);
+    CHECK((error <= 2 * (int64)JITTER_US) && (error >= -2 * (int64)JITTER_US));
+
+    // zu lange Laufzeit: Austausch wird verworfen
+    CHECK(Exchange(TSYNC_MAX_DELAY_US));
+    CHECK(TimeSync_stats.rejected == 1u);
+    CHECK(TimeSync_stats.exchanges == EXCHANGES);
+
+    return TestResult("test_tsync");
+}
@@ -0,0 +1,89 @@
+// Gegenstueck zu trace_replay fuer "make check": misst mit dem nachgebildeten
+// BMP180 (hal_sim.c) bei allen OSS, schreibt die Messwerte wie trace_replay
+// nach stdout und den I2C Mitschnitt so, wie ihn das Kommando TRACE ueber die
+// UART schickt ("TRACE n" und n Bytes), in die Datei argv[1]. Das Nachspielen
+// muss dieselben Werte liefern.
+
+#include <stdlib.h>
+#include "test.h"
+#include "bmp180.h"
+#include "bus.h"
+#include "hal.h"
+#include "out.h"
+#include "perf.h"
+#include "trace.h"
+
+#define SAMPLES     10u
+
+int main(int argc, char **argv)
+{
+    FILE *file;
+    uint16 length;
+    uint8 i;
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "usage: %s trace.bin\n", argv[0]);
+        return 2;
+    }
+
+    Perf_Init();
+    Out_Init();
+    Bus_Init();
+    BMP180_Init();
+
+    for (i = 0; i < SAMPLES; i++)
+    {
+        uint8 oss = i % (BMP180_OSS_MAX + 1u);
+        int16 ut;
+        int32 up;
+        int32 B5;
+
+        // Wandlungszeit abwarten, dann genau eine Statusabfrage wie acq.c
+        BMP180_SetOss(oss);
+        BMP180_StartTemperature();
+        Hal_DelayMs(BMP180_TEMP_CONV_MS);
+        while (!BMP180_ConversionDone())
+        {
+        }
+        ut = (int16)BMP180_ReadResult();
+        BMP180_StartPressure();
+        Hal_DelayMs(BMP180_PressureConvMs());
+        while (!BMP180_ConversionDone())
+        {
+        }
+        up = BMP180_ReadPressureResult();
+
+        B5 = BMP180_CalculateB5Fast(ut);
+        printf("%u,%u,%d,%ld,%ld,%ld\n", i, oss, ut, (long)up,
+               (long)BMP180_TemperatureX10(B5), (long)BMP180_CalculatePressure(up, B5));
+    }
+    if ((Trace_dropped > 0) || (BMP180_errors > 0))
+    {
+        fprintf(stderr, "trace_record: %lu dropped, %u bus errors\n", (unsigned long)Trace_dropped, BMP180_errors);
+        return 1;
+    }
+
+    Host_uartLength = 0;
+    length = Trace_StartDump();
+    Out_Print("TRACE ");
+    {
+        char count[8];
+        snprintf(count, sizeof(count), "%u\r\n", length);
+        Out_Print(count);
+    }
+    while (Trace_Dumping() || (Out_Pending() > 0))
+    {
+        Trace_DumpPoll();
+        Out_Poll();
+    }
+
+    file = fopen(argv[1], "wb");
+    if ((file == NULL) || (fwrite(Host_uartOut, 1, Host_uartLength, file) != Host_uartLength))
+    {
+        perror(argv[1]);
+        return 1;
+    }
+    fclose(file);
+    return 0;
+}
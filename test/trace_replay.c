@@ -0,0 +1,390 @@
+// Host Werkzeug fuer den I2C Mitschnitt (Format in trace.h):
+//
+//     trace_replay --list < trace.bin            Eintraege lesbar ausgeben
+//     trace_replay < trace.bin > samples.csv     Messungen nachspielen
+//     trace_replay --repeat 10000 < trace.bin    dasselbe als Benchmark
+//     trace_replay --capture < uart.bin          Dump hinter "TRACE n" im UART Mitschnitt
+//
+// Beim Nachspielen laufen bus.c und bmp180.c unveraendert, nur statt
+// hal_sim.c antworten die aufgezeichneten Transfers: Startbefehle werden der
+// Reihe nach im Mitschnitt gesucht, Ergebnisse in derselben Reihenfolge
+// geliefert, Statusabfragen (SCO) sind immer fertig und werden im Mitschnitt
+// uebersprungen. Die Kalibrierung kommt aus den aufgezeichneten Lesezugriffen
+// ab 0xAA; fehlt sie (Ring uebergelaufen oder im Sensor behalten), gilt das
+// Datenblattbeispiel. Ausgabe seq,oss,ut,up,temp_0.1c,pressure_pa; zwei
+// Laeufe vor und nach einer Treiberaenderung lassen sich direkt vergleichen.
+
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "bmp180.h"
+#include "bus.h"
+#include "hal.h"
+#include "perf.h"
+#include "trace.h"
+
+#define INPUT_MAX       (1u << 20)
+#define RECORDS_MAX     (INPUT_MAX / TRACE_HEADER)
+#define REG_CALIB       0xAAu
+#define CALIB_BYTES     22u
+
+typedef struct
+{
+    uint8 addr;
+    uint8 read;
+    uint8 result;
+    uint8 len;
+    uint16 dtUs;
+    const uint8 *data;
+} Record;
+
+static uint8 input[INPUT_MAX];
+static Record records[RECORDS_MAX];
+static uint32 recordCount;
+
+// Datenblattbeispiel wie in hal_sim.c
+static uint8 calib[CALIB_BYTES] =
+{
+    0x01, 0x98, 0xFF, 0xB8, 0xC7, 0xD1, 0x7F, 0xE5, 0x7F, 0xF5, 0x5A, 0x71,
+    0x18, 0x2E, 0x00, 0x04, 0x80, 0x00, 0xDD, 0xF9, 0x0B, 0x34
+};
+static uint8 calibFound;
+
+static uint32 cursor;           // naechster noch nicht nachgespielter Eintrag
+static uint8 ended;
+static uint8 simReg;
+static uint8 simStatus;
+static uint32 skipped;          // uebersprungene Eintraege (Statusabfragen, Fremdgeraete)
+static uint32 served;
+
+
+// Eintraege zerlegen, ein abgeschnittener letzter Eintrag wird ignoriert
+static uint32 Parse(const uint8 *data, uint32 length)
+{
+    uint32 pos = 0;
+
+    recordCount = 0;
+    while ((pos + TRACE_HEADER <= length) && (recordCount < RECORDS_MAX))
+    {
+        Record *r = &records[recordCount];
+        r->addr = data[pos] >> 1;
+        r->read = data[pos] & TRACE_READ;
+        r->result = data[pos + 1u];
+        r->len = data[pos + 2u];
+        r->dtUs = (uint16)(data[pos + 3u] | (data[pos + 4u] << 8));
+        r->data = &data[pos + TRACE_HEADER];
+        if (pos + TRACE_HEADER + r->len > length)
+        {
+            break;
+        }
+        pos += TRACE_HEADER + r->len;
+        recordCount++;
+    }
+    return pos;
+}
+
+static void List(void)
+{
+    uint64 t = 0;
+    uint32 i;
+    uint8 j;
+
+    for (i = 0; i < recordCount; i++)
+    {
+        const Record *r = &records[i];
+        t += r->dtUs;
+        printf("%10llu us  0x%02X %s %-5s", (unsigned long long)t, r->addr, r->read ? "R" : "W",
+               (r->result == BUS_OK) ? "ok" : (r->result == BUS_ERR_NAK) ? "nak" : "retry");
+        for (j = 0; j < r->len; j++)
+        {
+            printf(" %02X", r->data[j]);
+        }
+        printf("\n");
+    }
+}
+
+// Kalibrierung aus Registerzeiger + Lesen im Bereich 0xAA..0xBF
+static void FindCalibration(void)
+{
+    uint32 i;
+    uint8 j;
+
+    for (i = 0; i + 1u < recordCount; i++)
+    {
+        const Record *w = &records[i];
+        const Record *r = &records[i + 1u];
+        if ((w->addr == BMP180_ADDR) && !w->read && (w->len == 1u) && (w->result == BUS_OK) &&
+            (r->addr == BMP180_ADDR) && r->read && (r->result == BUS_OK) &&
+            (w->data[0] >= REG_CALIB) && (w->data[0] + r->len <= REG_CALIB + CALIB_BYTES))
+        {
+            for (j = 0; j < r->len; j++)
+            {
+                calib[w->data[0] - REG_CALIB + j] = r->data[j];
+            }
+            calibFound = 1;
+        }
+    }
+}
+
+static uint8 Status(uint8 result, uint8 done)
+{
+    if (result == BUS_ERR_NAK)
+    {
+        return I2C_MSTAT_ERR_ADDR_NAK | I2C_MSTAT_ERR_XFER;
+    }
+    if (result != BUS_OK)
+    {
+        // wie aufgezeichnet nochmal versuchen lassen
+        return I2C_MSTAT_ERR_XFER;
+    }
+    return done;
+}
+
+void Hal_SimStart(void)
+{
+    simStatus = 0;
+    simReg = 0;
+}
+
+uint8 Hal_SimWrite(uint8 addr, uint8 *data, uint8 len, uint8 mode)
+{
+    uint32 i;
+
+    simStatus = I2C_MSTAT_WR_CMPLT | ((mode & I2C_MODE_NO_STOP) ? I2C_MSTAT_XFER_HALT : 0u);
+    if ((addr != BMP180_ADDR) || (len == 0))
+    {
+        simStatus = I2C_MSTAT_ERR_ADDR_NAK | I2C_MSTAT_ERR_XFER;
+        return I2C_MSTR_NO_ERROR;
+    }
+    simReg = data[0];
+    if (len == 1u)
+    {
+        return I2C_MSTR_NO_ERROR;
+    }
+
+    // Startbefehl: naechsten gleichen Schreibzugriff im Mitschnitt suchen
+    for (i = cursor; i < recordCount; i++)
+    {
+        const Record *r = &records[i];
+        if ((r->addr == addr) && !r->read && (r->len == len) && (memcmp(r->data, data, len) == 0))
+        {
+            skipped += i - cursor;
+            cursor = i + 1u;
+            simStatus = Status(r->result, simStatus);
+            return I2C_MSTR_NO_ERROR;
+        }
+    }
+    ended = 1;
+    return I2C_MSTR_NO_ERROR;
+}
+
+uint8 Hal_SimRead(uint8 addr, uint8 *data, uint8 len, uint8 mode)
+{
+    uint32 i;
+    uint8 j;
+
+    (void)mode;
+    simStatus = I2C_MSTAT_RD_CMPLT;
+    memset(data, 0, len);
+    if (addr != BMP180_ADDR)
+    {
+        simStatus = I2C_MSTAT_ERR_ADDR_NAK | I2C_MSTAT_ERR_XFER;
+        return I2C_MSTR_NO_ERROR;
+    }
+    if ((simReg >= REG_CALIB) && (simReg + len <= REG_CALIB + CALIB_BYTES))
+    {
+        for (j = 0; j < len; j++)
+        {
+            data[j] = calib[simReg - REG_CALIB + j];
+        }
+        return I2C_MSTR_NO_ERROR;
+    }
+    if (simReg != BMP180_REG_RESULT)
+    {
+        // Statusabfrage: Wandlung immer fertig
+        return I2C_MSTR_NO_ERROR;
+    }
+
+    // Ergebnis: naechster Lesezugriff gleicher Laenge hinter dem Registerzeiger 0xF6
+    for (i = cursor; i < recordCount; i++)
+    {
+        const Record *r = &records[i];
+        const Record *w = &records[i - 1u];
+        if ((i > cursor) && (r->addr == addr) && r->read && (r->len == len) &&
+            !w->read && (w->len == 1u) && (w->data[0] == BMP180_REG_RESULT))
+        {
+            memcpy(data, r->data, len);
+            // der Registerzeiger davor gehoert dazu
+            skipped += (i - cursor) - 1u;
+            cursor = i + 1u;
+            served++;
+            simStatus = Status(r->result, simStatus);
+            return I2C_MSTR_NO_ERROR;
+        }
+    }
+    ended = 1;
+    return I2C_MSTR_NO_ERROR;
+}
+
+uint8 Hal_SimStatus(void)
+{
+    return simStatus;
+}
+
+void Hal_SimClearStatus(void)
+{
+    simStatus &= I2C_MSTAT_XFER_HALT;
+}
+
+void Hal_SimStop(void)
+{
+    simStatus = 0;
+}
+
+// OSS der naechsten Druckmessung aus ihrem Startbefehl, 0 wenn keine mehr kommt
+static uint8 NextOss(uint8 *oss)
+{
+    uint32 i;
+
+    for (i = cursor; i < recordCount; i++)
+    {
+        const Record *r = &records[i];
+        if ((r->addr == BMP180_ADDR) && !r->read && (r->len == 2u) && (r->data[0] == BMP180_REG_CTRL) &&
+            ((r->data[1] & 0x3Fu) == BMP180_CMD_PRES))
+        {
+            *oss = r->data[1] >> BMP180_OSS_SHIFT;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static uint32 Replay(uint8 print)
+{
+    uint32 samples = 0;
+    uint8 oss;
+
+    cursor = 0;
+    ended = 0;
+    while (!ended && NextOss(&oss))
+    {
+        int16 ut;
+        int32 up;
+        int32 B5;
+
+        BMP180_SetOss(oss);
+        BMP180_StartTemperature();
+        ut = (int16)BMP180_ReadResult();
+        BMP180_StartPressure();
+        up = BMP180_ReadPressureResult();
+        if (ended)
+        {
+            break;
+        }
+        B5 = BMP180_CalculateB5Fast(ut);
+        if (print)
+        {
+            printf("%lu,%u,%d,%ld,%ld,%ld\n", (unsigned long)samples, oss, ut, (long)up,
+                   (long)BMP180_TemperatureX10(B5), (long)BMP180_CalculatePressure(up, B5));
+        }
+        samples++;
+    }
+    return samples;
+}
+
+// Dump hinter der Zeile "TRACE n" in einem UART Mitschnitt
+static uint32 FromCapture(uint32 length)
+{
+    uint32 i;
+    unsigned long n;
+
+    for (i = 0; i < length; i++)
+    {
+        if (((i == 0) || (input[i - 1u] == '\n')) && (sscanf((const char *)&input[i], "TRACE %lu", &n) == 1))
+        {
+            const uint8 *end = memchr(&input[i], '\n', length - i);
+            uint32 start;
+            if (end == NULL)
+            {
+                break;
+            }
+            start = (uint32)(end - input) + 1u;
+            if (n > length - start)
+            {
+                n = length - start;
+            }
+            memmove(input, &input[start], n);
+            return (uint32)n;
+        }
+    }
+    fprintf(stderr, "no TRACE dump in capture\n");
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    uint32 length;
+    uint32 repeat = 0;
+    uint32 samples;
+    uint8 list = 0;
+    int i;
+
+    length = (uint32)fread(input, 1, sizeof(input), stdin);
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--list") == 0)
+        {
+            list = 1;
+        }
+        else if (strcmp(argv[i], "--capture") == 0)
+        {
+            length = FromCapture(length);
+        }
+        else if ((strcmp(argv[i], "--repeat") == 0) && (i + 1 < argc))
+        {
+            repeat = (uint32)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--list] [--capture] [--repeat n] < trace.bin\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (Parse(input, length) != length)
+    {
+        fprintf(stderr, "trailing %lu bytes ignored\n", (unsigned long)(length - Parse(input, length)));
+    }
+    if (list)
+    {
+        List();
+        return 0;
+    }
+
+    FindCalibration();
+    if (!calibFound)
+    {
+        fprintf(stderr, "no calibration in trace, using datasheet values\n");
+    }
+    Perf_Init();
+    Bus_Init();
+    Trace_capture = 0;
+    BMP180_Init();
+
+    samples = Replay(1);
+    fprintf(stderr, "%lu records, %lu samples, %lu skipped, bus errors %lu\n", (unsigned long)recordCount,
+            (unsigned long)samples, (unsigned long)skipped, (unsigned long)BMP180_errors);
+
+    if ((repeat > 0) && (samples > 0))
+    {
+        uint32 n;
+        uint64 total = 0;
+        double start = TestNowNs();
+        for (n = 0; n < repeat; n++)
+        {
+            total += Replay(0);
+        }
+        fprintf(stderr, "replay: %.0f ns/sample host\n", (TestNowNs() - start) / (double)total);
+    }
+    return 0;
+}
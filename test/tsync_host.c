@@ -0,0 +1,190 @@
+// Hostseite des Zeitabgleichs (tsync.h) an der seriellen Schnittstelle:
+//
+//     tsync_host /dev/ttyUSB0 [baud] [anzahl] [abstand_ms]
+//
+// Schickt alle abstand_ms ein "TS1 <t1>", nimmt die Antwort "TS <t1> <t2> <t3>"
+// entgegen und bestaetigt mit "TS2 <t1> <t4>". Hostzeit ist die Wanduhr
+// (CLOCK_REALTIME) in us, das Geraet stempelt damit seine Ausgaben. Je
+// Austausch eine Zeile t1,t2,t3,t4,offset_us,delay_us nach stdout; andere
+// Zeilen des Geraets (Messwerte) werden ignoriert.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/select.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#define LINE_MAX_CHARS  128
+#define REPLY_TIMEOUT_MS 1000
+
+static uint64_t NowUs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static speed_t Speed(unsigned long baud)
+{
+    switch (baud)
+    {
+    case 9600:
+        return B9600;
+    case 19200:
+        return B19200;
+    case 38400:
+        return B38400;
+    case 57600:
+        return B57600;
+    case 115200:
+        return B115200;
+    default:
+        return 0;
+    }
+}
+
+static int Open(const char *path, unsigned long baud)
+{
+    struct termios tio;
+    int fd = open(path, O_RDWR | O_NOCTTY);
+
+    if (fd < 0)
+    {
+        perror(path);
+        return -1;
+    }
+    if (tcgetattr(fd, &tio) != 0)
+    {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, Speed(baud));
+    cfsetospeed(&tio, Speed(baud));
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    if (tcsetattr(fd, TCSANOW, &tio) != 0)
+    {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+    tcflush(fd, TCIOFLUSH);
+    return fd;
+}
+
+static int Send(int fd, const char *line)
+{
+    size_t len = strlen(line);
+    return (write(fd, line, len) == (ssize_t)len) ? 0 : -1;
+}
+
+// wartet auf "TS <t1> ..." zu diesem t1; *t4 = Empfang des ersten Zeichens der Zeile
+static int Reply(int fd, uint64_t t1, uint64_t *t2, uint64_t *t3, uint64_t *t4)
+{
+    static char line[LINE_MAX_CHARS];
+    static size_t len;
+    static uint64_t lineStart;
+    uint64_t deadline = NowUs() + REPLY_TIMEOUT_MS * 1000u;
+
+    while (NowUs() < deadline)
+    {
+        fd_set set;
+        struct timeval tv = { 0, 10000 };
+        char c;
+
+        FD_ZERO(&set);
+        FD_SET(fd, &set);
+        if ((select(fd + 1, &set, NULL, NULL, &tv) <= 0) || (read(fd, &c, 1) != 1))
+        {
+            continue;
+        }
+        if (len == 0)
+        {
+            lineStart = NowUs();
+        }
+        if (c != '\n')
+        {
+            if ((c != '\r') && (len < sizeof(line) - 1u))
+            {
+                line[len++] = c;
+            }
+            continue;
+        }
+        line[len] = '\0';
+        len = 0;
+
+        unsigned long long a;
+        unsigned long long b;
+        unsigned long long d;
+        if ((sscanf(line, "TS %llu %llu %llu", &a, &b, &d) == 3) && (a == t1))
+        {
+            *t2 = b;
+            *t3 = d;
+            *t4 = lineStart;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long baud = (argc > 2) ? strtoul(argv[2], NULL, 0) : 9600u;
+    unsigned long count = (argc > 3) ? strtoul(argv[3], NULL, 0) : 60u;
+    unsigned long intervalMs = (argc > 4) ? strtoul(argv[4], NULL, 0) : 1000u;
+    unsigned long i;
+    unsigned long lost = 0;
+    int fd;
+
+    if ((argc < 2) || (Speed(baud) == 0))
+    {
+        fprintf(stderr, "usage: %s device [9600|19200|38400|57600|115200] [count] [interval_ms]\n", argv[0]);
+        return 2;
+    }
+    fd = Open(argv[1], baud);
+    if (fd < 0)
+    {
+        return 1;
+    }
+
+    printf("t1,t2,t3,t4,offset_us,delay_us\n");
+    for (i = 0; i < count; i++)
+    {
+        char buffer[64];
+        uint64_t t1;
+        uint64_t t2;
+        uint64_t t3;
+        uint64_t t4;
+
+        t1 = NowUs();
+        snprintf(buffer, sizeof(buffer), "TS1 %llu\n", (unsigned long long)t1);
+        if ((Send(fd, buffer) != 0) || (Reply(fd, t1, &t2, &t3, &t4) != 0))
+        {
+            lost++;
+            continue;
+        }
+        snprintf(buffer, sizeof(buffer), "TS2 %llu %llu\n", (unsigned long long)t1, (unsigned long long)t4);
+        if (Send(fd, buffer) != 0)
+        {
+            fprintf(stderr, "%s: %s\n", argv[1], strerror(errno));
+            break;
+        }
+        // gleiche Formeln wie TimeSync_Update() im Geraet
+        printf("%llu,%llu,%llu,%llu,%lld,%lld\n", (unsigned long long)t1, (unsigned long long)t2,
+               (unsigned long long)t3, (unsigned long long)t4,
+               (long long)(((int64_t)(t2 - t1) + (int64_t)(t3 - t4)) / 2),
+               (long long)((int64_t)(t4 - t1) - (int64_t)(t3 - t2)));
+        fflush(stdout);
+        usleep((useconds_t)(intervalMs * 1000u));
+    }
+    fprintf(stderr, "%lu exchanges, %lu without reply\n", count - lost, lost);
+    close(fd);
+    return 0;
+}